@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <thread>
+
+#include <unistd.h>
+
+#include "Process.hpp"
+
+/*
+ * runs rapid on every spec of the corpus (the examples in arrays, relational and cade27), records the wall time, the
+ * peak memory, the number of tasks and the size of each task, and compares them with a checked-in baseline.
+ * each spec is run several times, and the best (i.e. the smallest) time and memory of the runs are recorded.
+ * a spec regresses if it fails while it succeeded in the baseline, if it generates more tasks, or if its total output
+ * size or the size of one of its tasks exceeds the baseline by more than the tolerance.
+ * the runs of single specs are too short to compare their time and memory, so the corpus regresses if the sum of the
+ * times (resp. of the peak memory) of all specs exceeds the sum in the baseline by more than the tolerance. This is only
+ * checked if the baseline was recorded with the same build type on the same machine.
+ * returns 1 if anything regresses, 2 on wrong usage, and 0 otherwise.
+ *
+ * the baseline is a text file containing a line
+ *   spec <spec> <ok|failed> <seconds> <peak memory in KiB> <number of tasks> <total bytes>
+ * for each spec (relative to the examples directory), followed by a line
+ *   task <name> <bytes>
+ * for each task of the spec. Lines starting with # are comments, except for the lines
+ *   # build type: <build type>
+ *   # machine: <machine>
+ * which record where the baseline was measured.
+ */
+
+namespace {
+
+    // the corpus, as subdirectories of the examples directory
+    const std::vector<std::string> corpusDirectories = {"arrays", "relational", "cade27"};
+
+    class SpecResult
+    {
+    public:
+        SpecResult() : isOk(false), seconds(0), peakMemory(0), totalBytes(0), tasks() {}
+
+        bool isOk;
+        double seconds;
+        long peakMemory;
+        unsigned long long totalBytes;
+        // the size of each task in bytes, by name of the task
+        std::map<std::string, unsigned long long> tasks;
+    };
+
+    // where the results were measured
+    class Environment
+    {
+    public:
+        std::string buildType;
+        std::string machine;
+    };
+
+    class Tolerances
+    {
+    public:
+        Tolerances() : time(0.25), memory(0.1), bytes(0.02) {}
+
+        // the allowed relative increase of the total time and of the total memory of the corpus, and of the size of each spec and task
+        double time;
+        double memory;
+        double bytes;
+    };
+
+    void outputUsage()
+    {
+        std::cout << "Usage: rapid_corpus_bench <rapid executable> <examples directory> <baseline file> [options]\n"
+                  << "Options:\n"
+                  << "  -update                 write the measured values into the baseline file instead of comparing\n"
+                  << "  -results <file>         additionally write the measured values into the file (in the format of the baseline)\n"
+                  << "  -timeTolerance <r>      allowed relative increase of the total wall time of the corpus (default 0.25)\n"
+                  << "  -memoryTolerance <r>    allowed relative increase of the total peak memory of the corpus (default 0.1)\n"
+                  << "  -bytesTolerance <r>     allowed relative increase of the output size and of the size of each task (default 0.02)\n"
+                  << "  -repetitions <n>        number of runs of each spec, the best time and memory are used (default 5)\n"
+                  << "  -timeLimit <seconds>    time limit for each spec (default 600)\n"
+                  << "  -buildType <type>       the build type of rapid, recorded in the baseline (default unknown)\n";
+    }
+
+    // the specs of the corpus, relative to 'examplesDirectory', in alphabetical order
+    std::vector<std::string> corpusSpecs(const std::filesystem::path& examplesDirectory)
+    {
+        std::vector<std::string> specs;
+        for (const auto& directory : corpusDirectories)
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(examplesDirectory / directory))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".spec")
+                {
+                    specs.push_back(entry.path().lexically_relative(examplesDirectory).string());
+                }
+            }
+        }
+        std::sort(specs.begin(), specs.end());
+        return specs;
+    }
+
+    // the model of the processor and the number of processors
+    std::string currentMachine()
+    {
+        std::string model = "unknown processor";
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line))
+        {
+            if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos)
+            {
+                model = line.substr(line.find_first_not_of(" \t", line.find(':') + 1));
+                break;
+            }
+        }
+        return model + ", " + std::to_string(std::thread::hardware_concurrency()) + " cpus";
+    }
+
+    // run rapid 'repetitions' times on the spec, and record the best time and memory of the runs
+    SpecResult runSpec(const std::string& rapid, const std::filesystem::path& spec, const std::filesystem::path& outputDirectory, unsigned timeLimit, unsigned repetitions)
+    {
+        SpecResult result;
+        result.isOk = true;
+        for (unsigned i = 0; i < repetitions; ++i)
+        {
+            std::filesystem::remove_all(outputDirectory);
+            std::filesystem::create_directories(outputDirectory);
+
+            auto processResult = util::runProcess({rapid, "-dir", outputDirectory.string() + "/", spec.string()}, timeLimit, 0);
+            result.isOk = result.isOk && processResult.status == util::ProcessResult::Status::Exited && processResult.exitCode == 0;
+            result.seconds = i == 0 ? processResult.seconds : std::min(result.seconds, processResult.seconds);
+            result.peakMemory = i == 0 ? processResult.peakMemory : std::min(result.peakMemory, processResult.peakMemory);
+
+            // the output doesn't depend on the run
+            result.tasks.clear();
+            result.totalBytes = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(outputDirectory))
+            {
+                if (entry.path().extension() == ".smt2")
+                {
+                    auto bytes = entry.file_size();
+                    result.tasks[entry.path().stem().string()] = bytes;
+                    result.totalBytes += bytes;
+                }
+            }
+            if (!result.isOk)
+            {
+                break;
+            }
+        }
+        std::filesystem::remove_all(outputDirectory);
+        return result;
+    }
+
+    bool readBaseline(const std::string& fileName, std::map<std::string, SpecResult>& baseline, Environment& environment)
+    {
+        std::ifstream istr(fileName);
+        if (!istr)
+        {
+            return false;
+        }
+        std::string line;
+        SpecResult* current = nullptr;
+        while (std::getline(istr, line))
+        {
+            if (line.compare(0, 14, "# build type: ") == 0)
+            {
+                environment.buildType = line.substr(14);
+                continue;
+            }
+            if (line.compare(0, 11, "# machine: ") == 0)
+            {
+                environment.machine = line.substr(11);
+                continue;
+            }
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string kind;
+            fields >> kind;
+            if (kind == "spec")
+            {
+                std::string spec, status;
+                unsigned long numberOfTasks;
+                fields >> spec >> status;
+                current = &baseline[spec];
+                current->isOk = status == "ok";
+                fields >> current->seconds >> current->peakMemory >> numberOfTasks >> current->totalBytes;
+            }
+            else if (kind == "task" && current != nullptr)
+            {
+                // the size is the last field, since the name may contain spaces
+                auto separator = line.find_last_of(' ');
+                auto name = line.substr(5, separator - 5);
+                current->tasks[name] = std::stoull(line.substr(separator + 1));
+            }
+            else
+            {
+                std::cerr << "Error: Unexpected line in " << fileName << ": " << line << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void writeResults(std::ostream& ostr, const std::map<std::string, SpecResult>& results, const Environment& environment, unsigned repetitions)
+    {
+        ostr << "# rapid corpus baseline, see benchmarks/CorpusBenchmark.cpp\n";
+        ostr << "# build type: " << environment.buildType << "\n";
+        ostr << "# machine: " << environment.machine << "\n";
+        ostr << "# the best time and memory of " << repetitions << " runs of each spec\n";
+        ostr << "# spec <spec> <ok|failed> <seconds> <peak memory in KiB> <number of tasks> <total bytes>, followed by task <name> <bytes> for each task\n";
+        for (const auto& [spec, result] : results)
+        {
+            char seconds[32];
+            std::snprintf(seconds, sizeof(seconds), "%.6f", result.seconds);
+            ostr << "spec " << spec << " " << (result.isOk ? "ok" : "failed") << " " << seconds << " " << result.peakMemory << " " << result.tasks.size() << " " << result.totalBytes << "\n";
+            for (const auto& [name, bytes] : result.tasks)
+            {
+                ostr << "task " << name << " " << bytes << "\n";
+            }
+        }
+    }
+
+    bool exceeds(double value, double baseValue, double tolerance)
+    {
+        return value > baseValue * (1 + tolerance);
+    }
+
+    // compare the result of a spec with its baseline, and report each regression. Returns true iff the spec regressed.
+    bool compare(const std::string& spec, const SpecResult& result, const SpecResult& base, const Tolerances& tolerances)
+    {
+        std::vector<std::string> regressions;
+        if (base.isOk && !result.isOk)
+        {
+            regressions.push_back("rapid failed");
+        }
+        if (result.tasks.size() > base.tasks.size())
+        {
+            regressions.push_back(std::to_string(result.tasks.size()) + " tasks (baseline " + std::to_string(base.tasks.size()) + ")");
+        }
+        if (exceeds(result.totalBytes, base.totalBytes, tolerances.bytes))
+        {
+            regressions.push_back("output size " + std::to_string(result.totalBytes) + " bytes (baseline " + std::to_string(base.totalBytes) + " bytes)");
+        }
+        for (const auto& [name, bytes] : result.tasks)
+        {
+            auto it = base.tasks.find(name);
+            if (it != base.tasks.end() && exceeds(bytes, it->second, tolerances.bytes))
+            {
+                regressions.push_back("task " + name + ": " + std::to_string(bytes) + " bytes (baseline " + std::to_string(it->second) + " bytes)");
+            }
+        }
+
+        std::printf("%-80s %8.3f s %8ld KiB %5zu tasks %10llu bytes  %s\n", spec.c_str(), result.seconds, result.peakMemory, result.tasks.size(), result.totalBytes, regressions.empty() ? "ok" : "REGRESSION");
+        for (const auto& regression : regressions)
+        {
+            std::printf("    %s\n", regression.c_str());
+        }
+        return !regressions.empty();
+    }
+
+    /*
+     * compare the total time and memory of the specs which succeeded both in the results and in the baseline, and
+     * report each regression. Returns true iff the corpus regressed.
+     */
+    bool compareTotals(const std::map<std::string, SpecResult>& results, const std::map<std::string, SpecResult>& baseline, const Tolerances& tolerances)
+    {
+        double seconds = 0, baseSeconds = 0;
+        double peakMemory = 0, basePeakMemory = 0;
+        for (const auto& [spec, result] : results)
+        {
+            auto it = baseline.find(spec);
+            if (result.isOk && it != baseline.end() && it->second.isOk)
+            {
+                seconds += result.seconds;
+                baseSeconds += it->second.seconds;
+                peakMemory += result.peakMemory;
+                basePeakMemory += it->second.peakMemory;
+            }
+        }
+
+        bool timeRegressed = exceeds(seconds, baseSeconds, tolerances.time);
+        bool memoryRegressed = exceeds(peakMemory, basePeakMemory, tolerances.memory);
+        std::printf("total wall time   %10.3f s   (baseline %10.3f s)    %s\n", seconds, baseSeconds, timeRegressed ? "REGRESSION" : "ok");
+        std::printf("total peak memory %10.0f KiB (baseline %10.0f KiB)  %s\n", peakMemory, basePeakMemory, memoryRegressed ? "REGRESSION" : "ok");
+        return timeRegressed || memoryRegressed;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4)
+    {
+        outputUsage();
+        return 2;
+    }
+    std::string rapid = std::filesystem::absolute(argv[1]).string();
+    std::filesystem::path examplesDirectory = argv[2];
+    std::string baselineFile = argv[3];
+
+    bool update = false;
+    std::string resultsFile;
+    Tolerances tolerances;
+    unsigned timeLimit = 600;
+    unsigned repetitions = 5;
+    Environment environment;
+    environment.buildType = "unknown";
+    environment.machine = currentMachine();
+    for (int i = 4; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "-update")
+        {
+            update = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            outputUsage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (option == "-results")
+        {
+            resultsFile = value;
+        }
+        else if (option == "-timeTolerance")
+        {
+            tolerances.time = std::stod(value);
+        }
+        else if (option == "-memoryTolerance")
+        {
+            tolerances.memory = std::stod(value);
+        }
+        else if (option == "-bytesTolerance")
+        {
+            tolerances.bytes = std::stod(value);
+        }
+        else if (option == "-repetitions")
+        {
+            repetitions = std::max(std::stoul(value), 1ul);
+        }
+        else if (option == "-timeLimit")
+        {
+            timeLimit = std::stoul(value);
+        }
+        else if (option == "-buildType")
+        {
+            environment.buildType = value.empty() ? "unknown" : value;
+        }
+        else
+        {
+            outputUsage();
+            return 2;
+        }
+    }
+
+    std::map<std::string, SpecResult> baseline;
+    Environment baselineEnvironment;
+    if (!update && !readBaseline(baselineFile, baseline, baselineEnvironment))
+    {
+        std::cerr << "Error: Unable to read baseline " << baselineFile << std::endl;
+        return 2;
+    }
+
+    // the specs are run one after the other, so that their times don't influence each other
+    auto outputDirectory = std::filesystem::temp_directory_path() / ("rapid-corpus-" + std::to_string(getpid()));
+    std::map<std::string, SpecResult> results;
+    unsigned numberOfRegressions = 0;
+    for (const auto& spec : corpusSpecs(examplesDirectory))
+    {
+        auto result = runSpec(rapid, examplesDirectory / spec, outputDirectory, timeLimit, repetitions);
+        results[spec] = result;
+        if (update)
+        {
+            std::printf("%-80s %8.3f s %8ld KiB %5zu tasks %10llu bytes  %s\n", spec.c_str(), result.seconds, result.peakMemory, result.tasks.size(), result.totalBytes, result.isOk ? "ok" : "failed");
+            continue;
+        }
+        auto it = baseline.find(spec);
+        if (it == baseline.end())
+        {
+            std::printf("%-80s not in the baseline\n", spec.c_str());
+            continue;
+        }
+        if (compare(spec, result, it->second, tolerances))
+        {
+            numberOfRegressions++;
+        }
+    }
+    std::filesystem::remove_all(outputDirectory);
+
+    if (update || resultsFile != "")
+    {
+        auto fileName = update ? baselineFile : resultsFile;
+        std::ofstream ostr(fileName);
+        writeResults(ostr, results, environment, repetitions);
+        if (!ostr)
+        {
+            std::cerr << "Error: Unable to write " << fileName << std::endl;
+            return 2;
+        }
+    }
+    if (update)
+    {
+        std::cout << "Wrote the results of " << results.size() << " specs into " << baselineFile << std::endl;
+        return 0;
+    }
+
+    // times and memory are only comparable if they are measured with the same build on the same machine
+    bool totalsRegressed = false;
+    if (baselineEnvironment.buildType != environment.buildType || baselineEnvironment.machine != environment.machine)
+    {
+        std::cout << "Warning: The baseline was measured with build type " << baselineEnvironment.buildType << " on " << baselineEnvironment.machine
+                  << ", but rapid was built with build type " << environment.buildType << " and runs on " << environment.machine
+                  << ", so the wall time and the peak memory are not compared" << std::endl;
+    }
+    else
+    {
+        totalsRegressed = compareTotals(results, baseline, tolerances);
+    }
+    std::cout << numberOfRegressions << " of " << results.size() << " specs regressed" << (totalsRegressed ? ", and the total wall time or peak memory regressed" : "") << std::endl;
+    return numberOfRegressions > 0 || totalsRegressed ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Formula.hpp"
+#include "LogicContext.hpp"
+#include "Problem.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Theory.hpp"
+
+/*
+ * microbenchmarks for the core operations of the logic layer, using Google Benchmark.
+ * the results can be written in machine-readable form, e.g. using --benchmark_format=json, or using
+ * --benchmark_out=<file> --benchmark_out_format=json|csv, and two result files can be compared using
+ * the script compare.py of Google Benchmark.
+ * each benchmark uses its own logic context, which is destroyed after all nodes of the benchmark.
+ */
+
+using namespace logic;
+
+namespace {
+
+    // a new logic context, which is current during the lifetime of the object
+    class FreshContext
+    {
+    public:
+        FreshContext() : context(), scope(context) {}
+
+        LogicContext context;
+        LogicContext::Scope scope;
+    };
+
+    // the term f(f(...f(c)...)) containing 'depth' applications of f
+    std::shared_ptr<const Term> chain(unsigned depth, const std::string& constantName = "c")
+    {
+        std::shared_ptr<const Term> t = Terms::func(constantName, {}, Sorts::intSort());
+        for (unsigned i = 0; i < depth; ++i)
+        {
+            t = Terms::func("f", {t}, Sorts::intSort());
+        }
+        return t;
+    }
+
+    // the formula (and (= f^8(c_0) 0) (and (= f^8(c_1) 1) ... )), nested 'depth' times
+    std::shared_ptr<const Formula> nestedConjunction(unsigned depth)
+    {
+        auto f = Formulas::trueFormula();
+        for (unsigned i = 0; i < depth; ++i)
+        {
+            f = Formulas::conjunction({Formulas::equality(chain(8, "c_" + std::to_string(i)), Theory::intConstant(i)), f});
+        }
+        return f;
+    }
+
+    // a universally quantified conjunction of 'size' equations between terms of depth 8
+    std::shared_ptr<const Formula> largeFormula(unsigned size)
+    {
+        auto x = Signature::varSymbol("x", Sorts::intSort());
+        std::vector<std::shared_ptr<const Formula>> conjuncts;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            auto t = Theory::intAddition(Terms::var(x), Theory::intConstant(i));
+            for (unsigned j = 0; j < 8; ++j)
+            {
+                t = Terms::func("f", {t}, Sorts::intSort());
+            }
+            conjuncts.push_back(Formulas::equality(t, Terms::func("c_" + std::to_string(i), {}, Sorts::intSort())));
+        }
+        return Formulas::universal({x}, Formulas::conjunction(conjuncts));
+    }
+}
+
+#pragma mark - Terms
+
+// construct a term which has been constructed before, i.e. fetch it from the term bank
+static void BM_TermsFuncExisting(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto c = Terms::func("c", {}, Sorts::intSort());
+    auto f = Signature::fetchOrAdd("g", {Sorts::intSort(), Sorts::intSort()}, Sorts::intSort());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Terms::func(f, {c, c}));
+    }
+}
+BENCHMARK(BM_TermsFuncExisting);
+
+// as above, but the symbol is given by name
+static void BM_TermsFuncExistingByName(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto c = Terms::func("c", {}, Sorts::intSort());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Terms::func("g", {c, c}, Sorts::intSort()));
+    }
+}
+BENCHMARK(BM_TermsFuncExistingByName);
+
+// construct a chain of state.range(0) new terms
+static void BM_TermsFuncNew(benchmark::State& state)
+{
+    FreshContext fresh;
+    std::shared_ptr<const Symbol> f;
+    std::shared_ptr<const Term> t;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        t = nullptr;
+        f = nullptr;
+        fresh.context.reset();
+        f = Signature::fetchOrAdd("f", {Sorts::intSort()}, Sorts::intSort());
+        t = Terms::func("c", {}, Sorts::intSort());
+        state.ResumeTiming();
+
+        for (unsigned i = 0; i < state.range(0); ++i)
+        {
+            t = Terms::func(f, {t});
+        }
+    }
+    t = nullptr;
+    f = nullptr;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TermsFuncNew)->RangeMultiplier(8)->Range(8, 4096);
+
+#pragma mark - Signature
+
+static void BM_SignatureFetchOrAddExisting(benchmark::State& state)
+{
+    FreshContext fresh;
+    Signature::fetchOrAdd("g", {Sorts::intSort(), Sorts::intSort()}, Sorts::intSort());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Signature::fetchOrAdd("g", {Sorts::intSort(), Sorts::intSort()}, Sorts::intSort()));
+    }
+}
+BENCHMARK(BM_SignatureFetchOrAddExisting);
+
+// add state.range(0) new symbols
+static void BM_SignatureFetchOrAddNew(benchmark::State& state)
+{
+    FreshContext fresh;
+    std::vector<std::string> names;
+    for (unsigned i = 0; i < state.range(0); ++i)
+    {
+        names.push_back("g" + std::to_string(i));
+    }
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        fresh.context.reset();
+        auto intSort = Sorts::intSort();
+        state.ResumeTiming();
+
+        for (const auto& name : names)
+        {
+            benchmark::DoNotOptimize(Signature::fetchOrAdd(name, {intSort}, intSort));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignatureFetchOrAddNew)->RangeMultiplier(8)->Range(8, 4096);
+
+#pragma mark - Hashing and equality
+
+static void BM_TermHash(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto t = chain(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::hash<const Term>()(*t));
+    }
+}
+BENCHMARK(BM_TermHash)->Arg(1)->Arg(1024);
+
+// compare two deep terms which differ only in their innermost constant
+static void BM_TermEquality(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto t1 = chain(state.range(0), "c");
+    auto t2 = chain(state.range(0), "d");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(*t1 == *t1);
+        benchmark::DoNotOptimize(*t1 == *t2);
+    }
+}
+BENCHMARK(BM_TermEquality)->Arg(1)->Arg(1024);
+
+// compare two deep formulas which are structurally equal, but are different objects
+static void BM_FormulaEquality(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto f1 = nestedConjunction(state.range(0));
+    auto f2 = nestedConjunction(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(*f1 == *f2);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FormulaEquality)->RangeMultiplier(8)->Range(8, 4096);
+
+#pragma mark - Formulas
+
+// simplify a conjunction of state.range(0) formulas, every fourth of which is a true-formula
+static void BM_ConjunctionSimp(benchmark::State& state)
+{
+    FreshContext fresh;
+    std::vector<std::shared_ptr<const Formula>> conjuncts;
+    for (unsigned i = 0; i < state.range(0); ++i)
+    {
+        if (i % 4 == 0)
+        {
+            conjuncts.push_back(Formulas::trueFormula());
+        }
+        else
+        {
+            conjuncts.push_back(Formulas::equality(chain(8, "c_" + std::to_string(i % 64)), Theory::intConstant(i % 64)));
+        }
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Formulas::conjunctionSimp(conjuncts));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConjunctionSimp)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_FormulaToSMTLIB(benchmark::State& state)
+{
+    FreshContext fresh;
+    auto f = largeFormula(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        auto smtlib = f->toSMTLIB();
+        bytes = smtlib.size();
+        benchmark::DoNotOptimize(smtlib);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_FormulaToSMTLIB)->RangeMultiplier(8)->Range(8, 4096);
+
+#pragma mark - Problem
+
+// generate the reasoning tasks of a problem with state.range(0) items, every fourth of which is a lemma
+static void BM_GenerateReasoningTasks(benchmark::State& state)
+{
+    FreshContext fresh;
+    std::vector<std::shared_ptr<const ProblemItem>> items;
+    for (unsigned i = 0; i < state.range(0); ++i)
+    {
+        auto formula = Formulas::equality(chain(8, "c_" + std::to_string(i)), Theory::intConstant(i));
+        auto name = "item-" + std::to_string(i);
+        if (i % 4 == 3)
+        {
+            items.push_back(std::make_shared<Lemma>(formula, name));
+        }
+        else
+        {
+            items.push_back(std::make_shared<Axiom>(formula, name));
+        }
+    }
+    Problem problem(items);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(problem.generateReasoningTasks());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateReasoningTasks)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_MAIN();
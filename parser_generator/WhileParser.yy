@@ -657,6 +657,10 @@ expr:
 location:
   PROGRAM_ID                
   { 
+    if(!context.isProgramVarDeclared($1))
+    {
+      error(@1, $1 + " has not been declared");
+    }
   	auto var = context.getProgramVar($1);
     if(var->isArray)
     {
@@ -666,6 +670,10 @@ location:
   }
 | PROGRAM_ID LBRA expr RBRA 
   {
+    if(!context.isProgramVarDeclared($1))
+    {
+      error(@1, $1 + " has not been declared");
+    }
 	  auto var = context.getProgramVar($1);
     if(!var->isArray)
     {
@@ -679,8 +687,8 @@ location:
 void parser::WhileParser::error(const location_type& l,
                               const std::string& m)
 {
-  std::cout << "Error while parsing location " << l << ":\n" << m << std::endl;
+  *context.errors << "Error while parsing location " << l << ":\n" << m << std::endl;
   context.errorFlag = true;
-  exit(1);
+  throw parser::ParseError();
 }
 
@@ -18,11 +18,12 @@
 // The location of the current token.
 static parser::Location loc;
 
-void error(const parser::Location& l,
+void error(const parser::WhileParsingContext& context,
+           const parser::Location& l,
            const std::string& m)
 {
-    std::cout << l << m << std::endl;
-    exit(1);
+    *context.errors << l << m << std::endl;
+    throw parser::ParseError();
 }
 
 %}
@@ -111,11 +112,18 @@ mod          { return parser::WhileParser::make_MOD(loc); }
   errno = 0;
   long n = strtol (yytext, NULL, 10);
   if (! (INT_MIN <= n && n <= INT_MAX && errno != ERANGE))
-    error(loc, "integer out of range");
+    error(context, loc, "integer out of range");
   return parser::WhileParser::make_INTEGER(n, loc);
 }
-.            { error(loc, "invalid character");}
+.            { error(context, loc, "invalid character");}
 <<EOF>>      { return parser::WhileParser::make_END(loc); }
 
 %%
 
+// reset the state of the scanner, so that the next input can be scanned from the beginning
+void resetScanner()
+{
+  BEGIN(INITIAL);
+  loc = parser::Location();
+}
+
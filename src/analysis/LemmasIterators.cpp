@@ -31,6 +31,7 @@ namespace analysis {
         // add lemma for each intVar and each intArrayVar
         for (const auto& v : locationToActiveVars.at(locationSymbolForStatement(statement)->name))
         {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withVariable(v->name));
             if (!v->isConstant && assignedVars.find(v) != assignedVars.end())
             {
                 if (!v->isArray) // We assume that loop counters are not array elements and therefore only add iterator-lemmas for non-array-vars
@@ -206,6 +207,7 @@ namespace analysis {
         // add lemma for each intVar
         for (const auto& v : locationToActiveVars.at(locationSymbolForStatement(statement)->name))
         {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withVariable(v->name));
             if (!v->isConstant && assignedVars.find(v) != assignedVars.end())
             {
                 if (!v->isArray) // We assume that loop counters are not array elements and therefore only add iterator-lemmas for non-array-vars
@@ -22,6 +22,7 @@ namespace analysis {
         // add lemma for each intVar and each intArrayVar
         for (const auto& v : locationToActiveVars.at(locationSymbolForStatement(statement)->name))
         {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withVariable(v->name));
             if (!v->isConstant && assignedVars.find(v) != assignedVars.end())
             {
                 for (unsigned traceNumber1 = 1; traceNumber1 < numberOfTraces+1; traceNumber1++)
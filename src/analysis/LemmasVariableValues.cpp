@@ -40,6 +40,7 @@ namespace analysis {
         // add lemma for each intVar and each intArrayVar, for each variant
         for (const auto& v : locationToActiveVars.at(locationSymbolForStatement(whileStatement)->name))
         {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withVariable(v->name));
             if (!(v->isConstant) && assignedVars.find(v) != assignedVars.end())
             {
                 for (const auto predicate : predicates)
@@ -167,6 +168,7 @@ namespace analysis {
         // add a lemma asserting that var is the same in each iteration as in the first iteration.
         for (const auto& v : activeVars)
         {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withVariable(v->name));
             if (!v->isConstant && assignedVars.find(v) == assignedVars.end())
             {
                 for (unsigned traceNumber = 1; traceNumber < numberOfTraces+1; traceNumber++)
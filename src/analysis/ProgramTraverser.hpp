@@ -8,10 +8,13 @@
 #include <cassert>
 
 #include "Formula.hpp"
+#include "Problem.hpp"
 
 #include "Program.hpp"
 #include "Variable.hpp"
 
+#include "Trace.hpp"
+
 
 namespace analysis
 {
@@ -51,6 +54,10 @@ namespace analysis
     template <class OutputType>
     void ProgramTraverser<OutputType>::generate(OutputType& output)
     {
+        // the generated items and the span are named after the subclass, e.g. "analysis::ValueEvolutionLemmas"
+        auto generator = util::Trace::typeName(typeid(*this));
+        logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withGenerator(generator.substr(generator.rfind(':') + 1)));
+        util::Trace::Span span("traverser", util::Trace::isEnabled() ? generator : "");
         for(const auto& function : program.functions)
         {
             for (const auto& statement : function->statements)
@@ -95,6 +102,8 @@ namespace analysis
             case program::Statement::Type::WhileStatement:
             {
                 auto castedWhile = static_cast<const program::WhileStatement*>(statement);
+                logic::ItemOrigin::Scope originScope(logic::ItemOrigin::current().withLocation(castedWhile->location));
+                util::Trace::Span span("while", util::Trace::isEnabled() ? "while " + castedWhile->location : "");
                 
                 // generate output
                 generateOutputFor(castedWhile, output);
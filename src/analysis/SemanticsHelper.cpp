@@ -43,7 +43,7 @@ namespace analysis {
         return logic::Terms::var(iteratorSymbol(whileStatement));
     }
     
-    std::shared_ptr<const logic::Term> lastIterationTermForLoop(const program::WhileStatement* whileStatement, unsigned numberOfTraces, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Term> lastIterationTermForLoop(const program::WhileStatement* whileStatement, unsigned numberOfTraces, const std::shared_ptr<const logic::Term>& trace)
     {
         assert(whileStatement != nullptr);
         assert(trace != nullptr);
@@ -77,7 +77,7 @@ namespace analysis {
         return logic::Terms::func(locationSymbolForStatement(statement), enclosingIteratorTerms);
     }
     
-    std::shared_ptr<const logic::Term> timepointForLoopStatement(const program::WhileStatement* whileStatement, std::shared_ptr<const logic::Term> innerIteration)
+    std::shared_ptr<const logic::Term> timepointForLoopStatement(const program::WhileStatement* whileStatement, const std::shared_ptr<const logic::Term>& innerIteration)
     {
         assert(whileStatement != nullptr);
         assert(innerIteration != nullptr);
@@ -118,7 +118,7 @@ namespace analysis {
 
     
 # pragma mark - Methods for generating most used terms/predicates denoting program-expressions
-    std::shared_ptr<const logic::Term> toTerm(std::shared_ptr<const program::Variable> var, std::shared_ptr<const logic::Term> timePoint, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Term> toTerm(const std::shared_ptr<const program::Variable>& var, const std::shared_ptr<const logic::Term>& timePoint, const std::shared_ptr<const logic::Term>& trace)
     {
         assert(var != nullptr);
         assert(trace != nullptr);
@@ -140,7 +140,7 @@ namespace analysis {
         return logic::Terms::func(var->name, arguments, logic::Sorts::intSort());
     }
     
-    std::shared_ptr<const logic::Term> toTerm(std::shared_ptr<const program::Variable> var, std::shared_ptr<const logic::Term> timePoint, std::shared_ptr<const logic::Term> position, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Term> toTerm(const std::shared_ptr<const program::Variable>& var, const std::shared_ptr<const logic::Term>& timePoint, const std::shared_ptr<const logic::Term>& position, const std::shared_ptr<const logic::Term>& trace)
     {
         assert(var != nullptr);
         assert(position != nullptr);
@@ -166,7 +166,7 @@ namespace analysis {
         return logic::Terms::func(var->name, arguments, logic::Sorts::intSort());
     }
     
-    std::shared_ptr<const logic::Term> toTerm(std::shared_ptr<const program::IntExpression> expr, std::shared_ptr<const logic::Term> timePoint, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Term> toTerm(const std::shared_ptr<const program::IntExpression>& expr, const std::shared_ptr<const logic::Term>& timePoint, const std::shared_ptr<const logic::Term>& trace)
     {
         assert(expr != nullptr);
         assert(timePoint != nullptr);
@@ -211,7 +211,7 @@ namespace analysis {
         }
     }
 
-    std::shared_ptr<const logic::Formula> toFormula(std::shared_ptr<const program::BoolExpression> expr, std::shared_ptr<const logic::Term> timePoint, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Formula> toFormula(const std::shared_ptr<const program::BoolExpression>& expr, const std::shared_ptr<const logic::Term>& timePoint, const std::shared_ptr<const logic::Term>& trace)
     {
         assert(expr != nullptr);
         assert(timePoint != nullptr);
@@ -258,7 +258,7 @@ namespace analysis {
         }
     }
 
-    std::shared_ptr<const logic::Formula> varEqual(std::shared_ptr<const program::Variable> v, std::shared_ptr<const logic::Term> timePoint1, std::shared_ptr<const logic::Term> timePoint2, std::shared_ptr<const logic::Term> trace)
+    std::shared_ptr<const logic::Formula> varEqual(const std::shared_ptr<const program::Variable>& v, const std::shared_ptr<const logic::Term>& timePoint1, const std::shared_ptr<const logic::Term>& timePoint2, const std::shared_ptr<const logic::Term>& trace)
     {
         if(!v->isArray)
         {
@@ -282,7 +282,7 @@ namespace analysis {
         }
     }
 
-    std::shared_ptr<const logic::Formula> allVarEqual(const std::vector<std::shared_ptr<const program::Variable>>& activeVars, std::shared_ptr<const logic::Term> timePoint1, std::shared_ptr<const logic::Term> timePoint2, std::shared_ptr<const logic::Term> trace, std::string label)
+    std::shared_ptr<const logic::Formula> allVarEqual(const std::vector<std::shared_ptr<const program::Variable>>& activeVars, const std::shared_ptr<const logic::Term>& timePoint1, const std::shared_ptr<const logic::Term>& timePoint2, const std::shared_ptr<const logic::Term>& trace, std::string label)
     {
         std::vector<std::shared_ptr<const logic::Formula>> conjuncts;
         for (const auto& var : activeVars)
@@ -4,6 +4,7 @@
 #include "Theory.hpp"
 #include "Options.hpp"
 #include "Output.hpp"
+#include "Statistics.hpp"
 
 #include "SymbolDeclarations.hpp"
 #include "SemanticsHelper.hpp"
@@ -17,6 +18,19 @@ using namespace logic;
 
 namespace analysis {
 
+    namespace
+    {
+        // generate the lemmas of a family, recording the time and the number of generated items for the statistics
+        template <class Lemmas>
+        void generateLemmas(const std::string& family, Lemmas& lemmas, std::vector<std::shared_ptr<const logic::ProblemItem>>& items)
+        {
+            util::Statistics::ScopedTimer timer("trace-lemmas." + family);
+            auto numberOfItems = items.size();
+            lemmas.generate(items);
+            util::Statistics::add("items." + family, items.size() - numberOfItems);
+        }
+    }
+
 #pragma mark - High level methods
 
     std::vector<std::shared_ptr<const logic::ProblemItem>> generateTraceLemmas(
@@ -30,24 +44,24 @@ namespace analysis {
 
         // Lemmas to keep track of the values of variables at given timepoints
         ValueEvolutionLemmas valueEvolutionLemmas(program, locationToActiveVars, numberOfTraces);
-        valueEvolutionLemmas.generate(items);
+        generateLemmas("value-evolution", valueEvolutionLemmas, items);
 
         if (!util::Configuration::instance().inlineSemantics())
         {
             StaticAnalysisLemmas staticAnalysisLemmas(program, locationToActiveVars, numberOfTraces, programSemantics);
-            staticAnalysisLemmas.generate(items);
+            generateLemmas("static-analysis", staticAnalysisLemmas, items);
         }
 
         // Lemmas for iterators
         IntermediateValueLemmas intermediateValueLemmas(program, locationToActiveVars, numberOfTraces);
-        intermediateValueLemmas.generate(items);
+        generateLemmas("intermediate-value", intermediateValueLemmas, items);
 
         IterationInjectivityLemmas iterationInjectivityLemmas(program, locationToActiveVars, numberOfTraces);
-        iterationInjectivityLemmas.generate(items);
+        generateLemmas("iteration-injectivity", iterationInjectivityLemmas, items);
 
         // Other lemmas
         AtLeastOneIterationLemmas atLeastOneIterationLemmas(program, locationToActiveVars, numberOfTraces, programSemantics, inlinedVarValues);
-        atLeastOneIterationLemmas.generate(items);
+        generateLemmas("at-least-one-iteration", atLeastOneIterationLemmas, items);
 
         //            OrderingSynchronizationLemmas orderingSynchronizationLemmas(program, locationToActiveVars, numberOfTraces);
         //            orderingSynchronizationLemmas.generate(items);
@@ -56,10 +70,10 @@ namespace analysis {
         if (numberOfTraces > 1)
         {
             EqualityPreservationTracesLemmas equalityPreservationTracesLemmas(program, locationToActiveVars, numberOfTraces);
-            equalityPreservationTracesLemmas.generate(items);
+            generateLemmas("equality-preservation-traces", equalityPreservationTracesLemmas, items);
 
             NEqualLemmas nEqualLemmas(program, locationToActiveVars, numberOfTraces, programSemantics, inlinedVarValues);
-            nEqualLemmas.generate(items);
+            generateLemmas("n-equal", nEqualLemmas, items);
         }
 
         return items;
@@ -0,0 +1,131 @@
+#include "Rapid.hpp"
+
+#include <memory>
+#include <sstream>
+
+#include "LogicContext.hpp"
+#include "Options.hpp"
+#include "Output.hpp"
+#include "Statistics.hpp"
+
+#include "WhileParserWrapper.hpp"
+
+#include "Semantics.hpp"
+#include "TraceLemmas.hpp"
+#include "TheoryAxioms.hpp"
+
+namespace api {
+
+    GenerationResult generate(const std::string& specText, const Options& options, const std::string& specName)
+    {
+        GenerationResult result;
+        std::stringstream errors;
+
+        // start from the default values, independently of the configuration of the calling thread
+        util::Configuration configuration;
+        for (const auto& [name, value] : options)
+        {
+            auto option = configuration.getOption(name);
+            if (option == nullptr)
+            {
+                errors << "Unknown option " << name << "\n";
+            }
+            else if (!option->setValue(value))
+            {
+                errors << value << " is not a correct value for option " << name << "\n";
+            }
+        }
+
+        if (errors.str().empty())
+        {
+            util::Configuration::Scope configurationScope(configuration);
+            logic::LogicContext context;
+            logic::LogicContext::Scope contextScope(context);
+
+            // note: the tasks are destroyed before the context
+            std::vector<logic::ReasoningTask> tasks;
+            std::string preamble;
+            if (generateReasoningTasks(specText, specName, errors, tasks, preamble))
+            {
+                if (configuration.incremental())
+                {
+                    std::stringstream script;
+                    logic::outputIncrementalSMTLIB(tasks, script, preamble);
+                    result.tasks.emplace_back(specName, script.str());
+                }
+                else
+                {
+                    for (const auto& task : tasks)
+                    {
+                        std::stringstream smtlib;
+                        task.outputSMTLIB(smtlib, preamble);
+                        result.tasks.emplace_back(task.conjecture->name, smtlib.str());
+                    }
+                }
+                result.success = true;
+            }
+        }
+        result.errors = errors.str();
+        return result;
+    }
+
+    bool generateReasoningTasks(const std::string& specText, const std::string& specName, std::ostream& errors, std::vector<logic::ReasoningTask>& tasks, std::string& preamble)
+    {
+        std::unique_ptr<parser::WhileParserResult> parserResult;
+        {
+            util::Statistics::ScopedTimer timer("parse");
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin().withGenerator("user"));
+            parserResult = parser::tryParseString(specText, specName, errors);
+        }
+        if (parserResult == nullptr)
+        {
+            return false;
+        }
+
+        // generate problem
+        std::vector<std::shared_ptr<const logic::ProblemItem>> problemItems;
+
+        {
+            util::Statistics::ScopedTimer timer("theory-axioms");
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin().withGenerator("TheoryAxioms"));
+            analysis::TheoryAxioms theoryAxiomsGenerator;
+            auto theoryAxioms = theoryAxiomsGenerator.generate();
+            for (const auto& axiom : theoryAxioms)
+            {
+                problemItems.push_back(axiom);
+            }
+            util::Statistics::add("items.theory-axioms", theoryAxioms.size());
+        }
+
+        analysis::Semantics s(*parserResult->program, parserResult->locationToActiveVars, parserResult->problemItems, parserResult->numberOfTraces);
+        util::Statistics::ScopedTimer semanticsTimer("semantics");
+        auto [semantics, inlinedVarValues] = [&s]
+        {
+            logic::ItemOrigin::Scope originScope(logic::ItemOrigin().withGenerator("Semantics"));
+            return s.generateSemantics();
+        }();
+        semanticsTimer.stop();
+        problemItems.insert(problemItems.end(), semantics.begin(), semantics.end());
+        util::Statistics::add("items.semantics", semantics.size());
+
+        {
+            util::Statistics::ScopedTimer timer("trace-lemmas");
+            auto traceLemmas = analysis::generateTraceLemmas(*parserResult->program, parserResult->locationToActiveVars, parserResult->numberOfTraces, semantics, inlinedVarValues);
+            problemItems.insert(problemItems.end(), traceLemmas.begin(), traceLemmas.end());
+        }
+
+        problemItems.insert(problemItems.end(), parserResult->problemItems.begin(), parserResult->problemItems.end());
+        util::Statistics::add("items.user", parserResult->problemItems.size());
+
+        logic::Problem problem(problemItems);
+
+        // generate reasoning tasks
+        util::Statistics::ScopedTimer timer("reasoning-tasks");
+        std::stringstream programComment;
+        programComment << util::Output::comment << *parserResult->program << util::Output::nocomment;
+        preamble = programComment.str();
+        tasks = problem.generateReasoningTasks();
+        util::Statistics::add("reasoning tasks", tasks.size());
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef __Rapid__
+#define __Rapid__
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Problem.hpp"
+
+/*
+ * the interface for embedding rapid into other programs: generates the reasoning tasks of a spec given as text,
+ * and returns them in memory instead of writing them to files.
+ */
+namespace api {
+
+    // a reasoning task in SMTLIB syntax, i.e. the content of the file which rapid would generate for the task
+    class GeneratedTask
+    {
+    public:
+        GeneratedTask(std::string name, std::string smtlib) : name(std::move(name)), smtlib(std::move(smtlib)) {}
+
+        // the name of the conjecture of the task (the file would be named "<name>.smt2")
+        std::string name;
+        std::string smtlib;
+    };
+
+    class GenerationResult
+    {
+    public:
+        GenerationResult() : success(false), errors(), tasks() {}
+
+        // false if an option or the spec contains an error, in which case 'errors' contains the error messages
+        bool success;
+        std::string errors;
+        // the tasks in the order in which rapid outputs them. If the option -incremental is on, this is a single task
+        // (named after the spec) containing the incremental script for all tasks.
+        std::vector<GeneratedTask> tasks;
+    };
+
+    // options as pairs of name and value, using the names and values of the command line, e.g. {"-nat", "off"}
+    using Options = std::vector<std::pair<std::string, std::string>>;
+
+    /*
+     * generate the reasoning tasks of the spec 'specText'. The filesystem is not accessed.
+     * options which are not given keep their default values. Only the options which affect the content of the tasks
+     * are used (i.e. -dir, -threads, -outputCache, -batch, -server, the prover options, -stats, -trace and -sizeReport are ignored;
+     * the statistics and the trace are process-wide, see util::Statistics and util::Trace).
+     * errors in the options and errors detected while parsing the spec (e.g. syntax errors, or undeclared symbols or program
+     * variables) are returned in GenerationResult::errors: they are neither printed nor do they terminate the process. 'specName' is used in error messages.
+     * each call uses its own logic context and configuration, so calls can run concurrently in several threads
+     * (only parsing is done one spec at a time).
+     */
+    GenerationResult generate(const std::string& specText, const Options& options = {}, const std::string& specName = "input");
+
+    /*
+     * parse the spec 'specText' and generate its reasoning tasks, using the logic context and configuration which are
+     * current for the calling thread. 'preamble' is set to the text which is added at the beginning of each task
+     * (the program as comment). The tasks reference nodes of the logic context, so they must be destroyed before it.
+     * returns false if the spec contains an error, which has been reported to 'errors'.
+     */
+    bool generateReasoningTasks(const std::string& specText, const std::string& specName, std::ostream& errors, std::vector<logic::ReasoningTask>& tasks, std::string& preamble);
+}
+
+#endif
@@ -1,172 +1,247 @@
 #include "Formula.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "NodeArena.hpp"
+#include "SMTLIBWriter.hpp"
+#include "Statistics.hpp"
+
 namespace logic {
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Formula>>& f){ostr << "not implemented"; return ostr;}
     
-    std::string Formula::stringForLabel(unsigned indentation) const
+    std::size_t Formula::computeHash(const Symbol& symbol, const std::vector<std::shared_ptr<const Term>>& subterms)
     {
-        std::string str = "";
-        if (!label.empty())
+        size_t result = combineHash(std::hash<Type>()(Type::Predicate), std::hash<const Symbol>()(symbol));
+        for (const auto& subterm : subterms)
         {
-            str += std::string(indentation, ' ') + ";" + label + "\n";
+            result = combineHash(result, subterm->hash);
         }
-        return str;
+        return result;
     }
 
-    std::string PredicateFormula::toSMTLIB(unsigned indentation) const
+    std::size_t Formula::computeHash(bool polarity, const Term& left, const Term& right)
     {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ');
-        if (subterms.size() == 0)
-        {
-            str += symbol->toSMTLIB();
-        }
-        else
-        {
-            str += "(" + symbol->toSMTLIB() + " ";
-            for (unsigned i = 0; i < subterms.size(); i++)
-            {
-                str += subterms[i]->toSMTLIB();
-                str += (i == subterms.size() - 1) ? ")" : " ";
-            }
-        }
-        return str;
+        size_t result = combineHash(std::hash<Type>()(Type::Equality), std::hash<bool>()(polarity));
+        result = combineHash(result, left.hash);
+        return combineHash(result, right.hash);
     }
 
-    std::string EqualityFormula::toSMTLIB(unsigned indentation) const
+    std::size_t Formula::computeHash(Type type, const std::vector<std::shared_ptr<const Formula>>& subformulas)
     {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ');
-        if (polarity)
-        {
-            str += "(= " + left->toSMTLIB() + " " + right->toSMTLIB() + ")";
-        }
-        else
+        size_t result = std::hash<Type>()(type);
+        for (const auto& subformula : subformulas)
         {
-            str += "(not (= " + left->toSMTLIB() + " " + right->toSMTLIB() + "))";
+            result = combineHash(result, subformula->hash);
         }
-        return str;
+        return result;
     }
 
-    std::string ConjunctionFormula::toSMTLIB(unsigned indentation) const
+    std::size_t Formula::computeHash(Type type, const std::vector<std::shared_ptr<const Symbol>>& vars, const Formula& f)
     {
-        std::string str = stringForLabel(indentation);
-        if (conj.size() == 0)
+        size_t result = std::hash<Type>()(type);
+        for (const auto& var : vars)
         {
-            return str + std::string(indentation, ' ') + "true";
+            result = combineHash(result, std::hash<const Symbol>()(*var));
         }
-        str += std::string(indentation, ' ') + "(and\n";
-        for (unsigned i = 0; i < conj.size(); i++) {
-            str += conj[i]->toSMTLIB(indentation + 3) + "\n";
-        }
-        str += std::string(indentation, ' ') + ")";
-        return str;
+        return combineHash(result, f.hash);
     }
-    
-    std::string DisjunctionFormula::toSMTLIB(unsigned indentation) const
+
+    namespace
     {
-        std::string str = stringForLabel(indentation);
-        if (disj.size() == 0)
+        // variable symbols are interned by name and sort, so comparing their ids suffices
+        bool equalVars(const std::vector<std::shared_ptr<const Symbol>>& vars1, const std::vector<std::shared_ptr<const Symbol>>& vars2)
         {
-            return str + std::string(indentation, ' ') + "false";
-        }
-        str = std::string(indentation, ' ') + "(or\n";
-        for (unsigned i = 0; i < disj.size(); i++) {
-            str += disj[i]->toSMTLIB(indentation + 3) + "\n";
+            if (vars1.size() != vars2.size())
+            {
+                return false;
+            }
+            for (unsigned i = 0; i < vars1.size(); i++)
+            {
+                if (*vars1[i] != *vars2[i])
+                {
+                    return false;
+                }
+            }
+            return true;
         }
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-    
-    std::string NegationFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(not\n";
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        str += std::string(indentation, ' ') + ")";
-        return  str;
-    }
-    
-    std::string ExistentialFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(exists ";
-        
-        //list of quantified variables
-        str += "(";
-        for (const auto& var : vars)
+
+        // stack of pairs of formulas which still need to be compared.
+        // uses a fixed-size buffer and only falls back to the heap for very wide or deep formulas.
+        class ComparisonStack
         {
-            str += "(" + var->name + " " + var->rngSort->toSMTLIB() + ")";
-        }
-        str += ")\n";
-        
-        // formula
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        
-        str += std::string(indentation, ' ') + ")";
-        return str;
+        public:
+            ComparisonStack() : size(0), overflow() {}
+
+            bool empty() const { return size == 0 && overflow.empty(); }
+
+            void push(const Formula* f1, const Formula* f2)
+            {
+                if (size < bufferSize)
+                {
+                    buffer[size++] = std::make_pair(f1, f2);
+                }
+                else
+                {
+                    overflow.push_back(std::make_pair(f1, f2));
+                }
+            }
+
+            std::pair<const Formula*, const Formula*> pop()
+            {
+                if (!overflow.empty())
+                {
+                    auto pair = overflow.back();
+                    overflow.pop_back();
+                    return pair;
+                }
+                return buffer[--size];
+            }
+
+        private:
+            static const unsigned bufferSize = 64;
+            std::pair<const Formula*, const Formula*> buffer[bufferSize];
+            unsigned size;
+            std::vector<std::pair<const Formula*, const Formula*>> overflow;
+        };
     }
 
-    std::string UniversalFormula::toSMTLIB(unsigned indentation) const
+    bool operator==(const Formula& f1, const Formula& f2)
     {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(forall ";
-        
-        //list of quantified variables
-        str += "(";
-        for (const auto& var : vars)
+        ComparisonStack stack;
+        stack.push(&f1, &f2);
+
+        while (!stack.empty())
         {
-            str += "(" + var->name + " " + var->rngSort->toSMTLIB() + ")";
-        }
-        str += ")\n";
-        
-        // formula
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-    
-    std::string ImplicationFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
+            auto [g1, g2] = stack.pop();
+            if (g1 == g2)
+            {
+                continue;
+            }
+            if (g1->hash != g2->hash || g1->type() != g2->type())
+            {
+                return false;
+            }
 
-        str += std::string(indentation, ' ') + "(=>\n";
-        str += f1->toSMTLIB(indentation + 3) + "\n";
-        str += f2->toSMTLIB(indentation + 3) + "\n";
-        str += std::string(indentation, ' ') + ")";
-        return  str;
+            switch (g1->type())
+            {
+                case Formula::Type::Predicate:
+                {
+                    auto p1 = static_cast<const PredicateFormula*>(g1);
+                    auto p2 = static_cast<const PredicateFormula*>(g2);
+                    // terms are hash-consed, so comparing the subterm-pointers suffices
+                    if (*p1->symbol != *p2->symbol || p1->subterms != p2->subterms)
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                case Formula::Type::Equality:
+                {
+                    auto e1 = static_cast<const EqualityFormula*>(g1);
+                    auto e2 = static_cast<const EqualityFormula*>(g2);
+                    if (e1->polarity != e2->polarity || e1->left != e2->left || e1->right != e2->right)
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                case Formula::Type::Conjunction:
+                case Formula::Type::Disjunction:
+                {
+                    const auto& sub1 = (g1->type() == Formula::Type::Conjunction) ? static_cast<const ConjunctionFormula*>(g1)->conj : static_cast<const DisjunctionFormula*>(g1)->disj;
+                    const auto& sub2 = (g2->type() == Formula::Type::Conjunction) ? static_cast<const ConjunctionFormula*>(g2)->conj : static_cast<const DisjunctionFormula*>(g2)->disj;
+                    if (sub1.size() != sub2.size())
+                    {
+                        return false;
+                    }
+                    for (unsigned i = 0; i < sub1.size(); i++)
+                    {
+                        stack.push(sub1[i].get(), sub2[i].get());
+                    }
+                    break;
+                }
+                case Formula::Type::Negation:
+                {
+                    stack.push(static_cast<const NegationFormula*>(g1)->f.get(), static_cast<const NegationFormula*>(g2)->f.get());
+                    break;
+                }
+                case Formula::Type::Existential:
+                {
+                    auto q1 = static_cast<const ExistentialFormula*>(g1);
+                    auto q2 = static_cast<const ExistentialFormula*>(g2);
+                    if (!equalVars(q1->vars, q2->vars))
+                    {
+                        return false;
+                    }
+                    stack.push(q1->f.get(), q2->f.get());
+                    break;
+                }
+                case Formula::Type::Universal:
+                {
+                    auto q1 = static_cast<const UniversalFormula*>(g1);
+                    auto q2 = static_cast<const UniversalFormula*>(g2);
+                    if (!equalVars(q1->vars, q2->vars))
+                    {
+                        return false;
+                    }
+                    stack.push(q1->f.get(), q2->f.get());
+                    break;
+                }
+                case Formula::Type::Implication:
+                {
+                    auto i1 = static_cast<const ImplicationFormula*>(g1);
+                    auto i2 = static_cast<const ImplicationFormula*>(g2);
+                    stack.push(i1->f1.get(), i2->f1.get());
+                    stack.push(i1->f2.get(), i2->f2.get());
+                    break;
+                }
+                case Formula::Type::Equivalence:
+                {
+                    auto e1 = static_cast<const EquivalenceFormula*>(g1);
+                    auto e2 = static_cast<const EquivalenceFormula*>(g2);
+                    stack.push(e1->f1.get(), e2->f1.get());
+                    stack.push(e1->f2.get(), e2->f2.get());
+                    break;
+                }
+                case Formula::Type::True:
+                case Formula::Type::False:
+                {
+                    break;
+                }
+                default:
+                {
+                    assert(false);
+                    break;
+                }
+            }
+        }
+        return true;
     }
 
-    std::string EquivalenceFormula::toSMTLIB(unsigned indentation) const
+    bool operator!=(const Formula& f1, const Formula& f2)
     {
-        std::string str = stringForLabel(indentation);
-
-        str += std::string(indentation, ' ') + "(=\n";
-        str += f1->toSMTLIB(indentation + 3) + "\n";
-        str += f2->toSMTLIB(indentation + 3) + "\n";
-        str += std::string(indentation, ' ') + ")";
-        return  str;
+        return !(f1 == f2);
     }
 
-    std::string TrueFormula::toSMTLIB(unsigned indentation) const
+    std::string Formula::toSMTLIB(unsigned indentation) const
     {
-        std::string str = stringForLabel(indentation);
-        return str + std::string(indentation, ' ') + "true";
+        std::stringstream ss;
+        SMTLIBWriter(ss).write(*this, indentation);
+        return ss.str();
     }
 
-    std::string FalseFormula::toSMTLIB(unsigned indentation) const
+    std::ostream& operator<<(std::ostream& ostr, const Formula& e)
     {
-        std::string str = stringForLabel(indentation);
-        return str + std::string(indentation, ' ') + "false";
+        SMTLIBWriter(ostr).write(e);
+        return ostr;
     }
 
     std::string PredicateFormula::prettyString(unsigned indentation) const
@@ -285,62 +360,83 @@ namespace logic {
     }
     
 # pragma mark - Formulas
-    std::shared_ptr<const Formula> Formulas::predicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label, bool noDeclaration)
+
+    static util::Statistics::Counter formulasCreated("formulas created");
+
+    // construct a new formula node, counting it for the statistics
+    template<typename T, typename... Args>
+    static std::shared_ptr<const T> newFormula(Args&&... args)
     {
-        std::vector<const Sort*> subtermSorts;
-        for (const auto& subterm : subterms)
-        {
-            subtermSorts.push_back(subterm->symbol->rngSort);
-        }
-        auto symbol = Signature::fetchOrAdd(name, subtermSorts, Sorts::boolSort(), false, noDeclaration);
-        return std::make_shared<const PredicateFormula>(symbol, subterms, label);
+        formulasCreated.increment();
+        return newNode<T>(std::forward<Args>(args)...);
+    }
+
+    std::shared_ptr<const Formula> Formulas::predicate(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, std::string label, bool noDeclaration)
+    {
+        auto symbol = fetchOrAddPredicateSymbol(name, subterms, false, noDeclaration);
+        return newFormula<PredicateFormula>(symbol, std::move(subterms), label);
     }
-    std::shared_ptr<const Formula> Formulas::lemmaPredicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label)
+    std::shared_ptr<const Formula> Formulas::lemmaPredicate(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, std::string label)
     {
-        std::vector<const Sort*> subtermSorts;
-        for (const auto& subterm : subterms)
+        auto symbol = fetchOrAddPredicateSymbol(name, subterms, true, false);
+        return newFormula<PredicateFormula>(symbol, std::move(subterms), label);
+    }
+
+    std::shared_ptr<const Symbol> Formulas::fetchOrAddPredicateSymbol(const std::string& name, const std::vector<std::shared_ptr<const Term>>& subterms, bool isLemmaPredicate, bool noDeclaration)
+    {
+        // usually the symbol already exists, in which case there is no need to collect the sorts of the subterms
+        // (the sorts of the subterms are checked when the formula is constructed)
+        auto symbol = Signature::tryFetch(name);
+        if (symbol == nullptr || symbol->argSorts.size() != subterms.size())
         {
-            subtermSorts.push_back(subterm->symbol->rngSort);
+            std::vector<const Sort*> subtermSorts;
+            for (const auto& subterm : subterms)
+            {
+                subtermSorts.push_back(subterm->symbol->rngSort);
+            }
+            symbol = Signature::fetchOrAdd(name, subtermSorts, Sorts::boolSort(), isLemmaPredicate, noDeclaration);
         }
-        auto symbol = Signature::fetchOrAdd(name, subtermSorts, Sorts::boolSort(), true, false);
-        return std::make_shared<const PredicateFormula>(symbol, subterms, label);
+        assert(symbol->rngSort == Sorts::boolSort());
+        assert(symbol->isLemmaPredicate == isLemmaPredicate);
+        assert(symbol->noDeclaration == noDeclaration);
+        return symbol;
     }
 
-    std::shared_ptr<const Formula> Formulas::equality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
+    std::shared_ptr<const Formula> Formulas::equality(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label)
     {
-        return std::make_shared<const EqualityFormula>(true, left, right, label);
+        return newFormula<EqualityFormula>(true, left, right, label);
     }
     
-    std::shared_ptr<const Formula> Formulas::disequality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
+    std::shared_ptr<const Formula> Formulas::disequality(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label)
     {
-        auto eq = std::make_shared<const EqualityFormula>(true, left, right);
-        return std::make_shared<const NegationFormula>(eq, label);
+        auto eq = newFormula<EqualityFormula>(true, left, right);
+        return newFormula<NegationFormula>(eq, label);
     }
     
-    std::shared_ptr<const Formula>  Formulas::negation(std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula>  Formulas::negation(const std::shared_ptr<const Formula>& f, std::string label)
     {
-        return std::make_shared<const NegationFormula>(f, label);
+        return newFormula<NegationFormula>(f, label);
     }
     
     std::shared_ptr<const Formula> Formulas::conjunction(std::vector<std::shared_ptr<const Formula>> conj, std::string label)
     {
-        return std::make_shared<const ConjunctionFormula>(conj, label);
+        return newFormula<ConjunctionFormula>(std::move(conj), label);
     }
     std::shared_ptr<const Formula> Formulas::disjunction(std::vector<std::shared_ptr<const Formula>> disj, std::string label)
     {
-        return std::make_shared<const DisjunctionFormula>(disj, label);
+        return newFormula<DisjunctionFormula>(std::move(disj), label);
     }
     
-    std::shared_ptr<const Formula> Formulas::implication(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label)
+    std::shared_ptr<const Formula> Formulas::implication(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label)
     {
-        return std::make_shared<const ImplicationFormula>(f1, f2, label);
+        return newFormula<ImplicationFormula>(f1, f2, label);
     }
-    std::shared_ptr<const Formula> Formulas::equivalence(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label)
+    std::shared_ptr<const Formula> Formulas::equivalence(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label)
     {
-        return std::make_shared<const EquivalenceFormula>(f1, f2, label);
+        return newFormula<EquivalenceFormula>(f1, f2, label);
     }
     
-    std::shared_ptr<const Formula> Formulas::existential(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula> Formulas::existential(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label)
     {
         if (vars.empty())
         {
@@ -348,10 +444,10 @@ namespace logic {
         }
         else
         {
-            return std::make_shared<const ExistentialFormula>(std::move(vars), f, label);
+            return newFormula<ExistentialFormula>(std::move(vars), f, label);
         }
     }
-    std::shared_ptr<const Formula> Formulas::universal(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula> Formulas::universal(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label)
     {
         if (vars.empty())
         {
@@ -359,20 +455,20 @@ namespace logic {
         }
         else
         {
-            return std::make_shared<const UniversalFormula>(std::move(vars), f, label);
+            return newFormula<UniversalFormula>(std::move(vars), f, label);
         }
     }
 
     std::shared_ptr<const Formula> Formulas::trueFormula(std::string label)
     {
-        return std::make_shared<const TrueFormula>(label);
+        return newFormula<TrueFormula>(label);
     }
     std::shared_ptr<const Formula> Formulas::falseFormula(std::string label)
     {
-        return std::make_shared<const FalseFormula>(label);
+        return newFormula<FalseFormula>(label);
     }
 
-    std::shared_ptr<const Formula> Formulas::equalitySimp(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
+    std::shared_ptr<const Formula> Formulas::equalitySimp(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label)
     {
         if (*left == *right)
         {
@@ -381,7 +477,7 @@ namespace logic {
         return equality(left, right, label);
     }
     
-    std::shared_ptr<const Formula> Formulas::disequalitySimp(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
+    std::shared_ptr<const Formula> Formulas::disequalitySimp(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label)
     {
         if (*left == *right)
         {
@@ -390,7 +486,7 @@ namespace logic {
         return disequality(left, right, label);
     }
     
-    std::shared_ptr<const Formula>  Formulas::negationSimp(std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula>  Formulas::negationSimp(const std::shared_ptr<const Formula>& f, std::string label)
     {
         if (f->type() == Formula::Type::True)
         {
@@ -459,7 +555,7 @@ namespace logic {
         return disjunction(disj, label);
     }
     
-    std::shared_ptr<const Formula> Formulas::implicationSimp(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label)
+    std::shared_ptr<const Formula> Formulas::implicationSimp(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label)
     {
         if (f1->type() == Formula::Type::False || f2->type() == Formula::Type::True)
         {
@@ -477,7 +573,7 @@ namespace logic {
         return implication(f1, f2, label);
     }
 
-    std::shared_ptr<const Formula> Formulas::equivalenceSimp(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label)
+    std::shared_ptr<const Formula> Formulas::equivalenceSimp(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label)
     {
         if (f1->type() == Formula::Type::True)
         {
@@ -499,7 +595,7 @@ namespace logic {
         return equivalence(f1, f2, label);
     }
     
-    std::shared_ptr<const Formula> Formulas::existentialSimp(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula> Formulas::existentialSimp(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label)
     {
         if (f->type() == Formula::Type::True || f->type() == Formula::Type::False)
         {
@@ -508,7 +604,7 @@ namespace logic {
 
         return existential(vars, f, label);
     }
-    std::shared_ptr<const Formula> Formulas::universalSimp(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula> Formulas::universalSimp(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label)
     {
         if (f->type() == Formula::Type::True || f->type() == Formula::Type::False)
         {
@@ -518,14 +614,14 @@ namespace logic {
         return universal(vars, f, label);
     }
 
-    std::shared_ptr<const Formula> Formulas::copyWithLabel(std::shared_ptr<const Formula> f, std::string label)
+    std::shared_ptr<const Formula> Formulas::copyWithLabel(const std::shared_ptr<const Formula>& f, std::string label)
     {
         switch (f->type())
         {
             case logic::Formula::Type::Predicate:
             {
                 auto castedFormula = std::static_pointer_cast<const logic::PredicateFormula>(f);
-                return std::make_shared<const PredicateFormula>(castedFormula->symbol, castedFormula->subterms, label);
+                return newFormula<PredicateFormula>(castedFormula->symbol, castedFormula->subterms, label);
             }
             case logic::Formula::Type::Equality:
             {
@@ -1,6 +1,8 @@
 #ifndef __Formula__
 #define __Formula__
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -15,9 +17,11 @@ namespace logic {
     class Formula
     {
     public:
-        Formula(std::string label) : label(label) {}
+        Formula(std::string label, std::size_t hash) : label(label), hash(hash) {}
         virtual ~Formula() {}
         const std::string label;
+        // structural hash of the formula (labels are ignored), computed once when the formula is constructed.
+        const std::size_t hash;
 
         enum class Type
         {
@@ -35,12 +39,26 @@ namespace logic {
         };
         virtual Type type() const = 0;
         
-        virtual std::string toSMTLIB(unsigned indentation = 0) const = 0;
+        // note: for writing large formulas to a stream, use SMTLIBWriter directly
+        std::string toSMTLIB(unsigned indentation = 0) const;
         virtual std::string prettyString(unsigned indentation = 0) const = 0;
         
     protected:
-        std::string stringForLabel(unsigned indentation) const;
+        // helpers for computing the structural hash of the different kinds of formulas
+        static std::size_t combineHash(std::size_t seed, std::size_t value) { return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2)); }
+        static std::size_t computeHash(const Symbol& symbol, const std::vector<std::shared_ptr<const Term>>& subterms);
+        static std::size_t computeHash(bool polarity, const Term& left, const Term& right);
+        static std::size_t computeHash(Type type, const std::vector<std::shared_ptr<const Formula>>& subformulas);
+        static std::size_t computeHash(Type type, const std::vector<std::shared_ptr<const Symbol>>& vars, const Formula& f);
     };
+
+    /*
+     * structural equality of formulas, which ignores labels.
+     * the comparison is iterative and exits early as soon as the cached hashes of two compared subformulas differ.
+     * terms are compared by identity, since they are hash-consed.
+     */
+    bool operator==(const Formula& f1, const Formula& f2);
+    bool operator!=(const Formula& f1, const Formula& f2);
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Formula>>& f);
@@ -50,9 +68,9 @@ namespace logic {
         friend class Formulas;
         
     public:
-        PredicateFormula(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "") : Formula(label), symbol(symbol), subterms(subterms)
+        PredicateFormula(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "") : Formula(label, computeHash(*symbol, subterms)), symbol(symbol), subterms(std::move(subterms))
         {
-            assert(symbol->argSorts.size() == subterms.size());
+            assert(symbol->argSorts.size() == this->subterms.size());
             for (int i=0; i < symbol->argSorts.size(); ++i)
             {
                 assert(symbol->argSorts[i] == this->subterms[i]->symbol->rngSort);
@@ -63,7 +81,6 @@ namespace logic {
         const std::vector<std::shared_ptr<const Term>> subterms;
 
         Type type() const override { return Formula::Type::Predicate; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -74,14 +91,13 @@ namespace logic {
     public:
         // TODO: refactor polarity into explicit negation everywhere
         EqualityFormula(bool polarity, std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "")
-        : Formula(label), polarity(polarity), left(left), right(right) {}
+        : Formula(label, computeHash(polarity, *left, *right)), polarity(polarity), left(left), right(right) {}
 
         const bool polarity;
         const std::shared_ptr<const Term> left;
         const std::shared_ptr<const Term> right;
         
         Type type() const override { return Formula::Type::Equality; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -90,12 +106,11 @@ namespace logic {
         friend class Formulas;
         
     public:
-        ConjunctionFormula(std::vector<std::shared_ptr<const Formula>> conj, std::string label = "") : Formula(label), conj(conj) {}
+        ConjunctionFormula(std::vector<std::shared_ptr<const Formula>> conj, std::string label = "") : Formula(label, computeHash(Type::Conjunction, conj)), conj(std::move(conj)) {}
         
         const std::vector<std::shared_ptr<const Formula>> conj;
 
         Type type() const override { return Formula::Type::Conjunction; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -104,12 +119,11 @@ namespace logic {
         friend class Formulas;
         
     public:
-        DisjunctionFormula(std::vector<std::shared_ptr<const Formula>> disj, std::string label = "") : Formula(label), disj(disj){}
+        DisjunctionFormula(std::vector<std::shared_ptr<const Formula>> disj, std::string label = "") : Formula(label, computeHash(Type::Disjunction, disj)), disj(std::move(disj)){}
         
         const std::vector<std::shared_ptr<const Formula>> disj;
 
         Type type() const override { return Formula::Type::Disjunction; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -118,12 +132,11 @@ namespace logic {
         friend class Formulas;
         
     public:
-        NegationFormula(std::shared_ptr<const Formula> f, std::string label = "") : Formula(label), f(f) {}
+        NegationFormula(std::shared_ptr<const Formula> f, std::string label = "") : Formula(label, combineHash(std::hash<Type>()(Type::Negation), f->hash)), f(f) {}
         
         const std::shared_ptr<const Formula> f;
 
         Type type() const override { return Formula::Type::Negation; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
         
     };
@@ -134,7 +147,7 @@ namespace logic {
         
     public:
         ExistentialFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "")
-        : Formula(label), vars(std::move(vars)), f(f)
+        : Formula(label, computeHash(Type::Existential, vars, *f)), vars(std::move(vars)), f(f)
         {
             for (const auto& var : vars)
             {
@@ -146,7 +159,6 @@ namespace logic {
         const std::shared_ptr<const Formula> f;
         
         Type type() const override { return Formula::Type::Existential; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -156,7 +168,7 @@ namespace logic {
         
     public:
         UniversalFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "")
-        : Formula(label), vars(std::move(vars)), f(f)
+        : Formula(label, computeHash(Type::Universal, vars, *f)), vars(std::move(vars)), f(f)
         {
             for (const auto& var : vars)
             {
@@ -168,7 +180,6 @@ namespace logic {
         const std::shared_ptr<const Formula> f;
         
         Type type() const override { return Formula::Type::Universal; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -178,13 +189,12 @@ namespace logic {
         
     public:
         ImplicationFormula(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "")
-        : Formula(label), f1(f1), f2(f2) {}
+        : Formula(label, combineHash(combineHash(std::hash<Type>()(Type::Implication), f1->hash), f2->hash)), f1(f1), f2(f2) {}
         
         const std::shared_ptr<const Formula> f1;
         const std::shared_ptr<const Formula> f2;
         
         Type type() const override { return Formula::Type::Implication; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
 
@@ -194,13 +204,12 @@ namespace logic {
 
     public:
         EquivalenceFormula(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "")
-        : Formula(label), f1(f1), f2(f2) {}
+        : Formula(label, combineHash(combineHash(std::hash<Type>()(Type::Equivalence), f1->hash), f2->hash)), f1(f1), f2(f2) {}
 
         const std::shared_ptr<const Formula> f1;
         const std::shared_ptr<const Formula> f2;
 
         Type type() const override { return Formula::Type::Equivalence; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
 
@@ -209,10 +218,9 @@ namespace logic {
         friend class Formulas;
         
     public:
-        TrueFormula(std::string label = "") : Formula(label) {}
+        TrueFormula(std::string label = "") : Formula(label, std::hash<Type>()(Type::True)) {}
         
         Type type() const override { return Formula::Type::True; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -221,13 +229,12 @@ namespace logic {
         friend class Formulas;
         
     public:
-        FalseFormula(std::string label = "") : Formula(label) {}
+        FalseFormula(std::string label = "") : Formula(label, std::hash<Type>()(Type::False)) {}
         
         Type type() const override { return Formula::Type::False; }
-        std::string toSMTLIB(unsigned indentation = 0) const override;
         std::string prettyString(unsigned indentation = 0) const override;
     };
-    inline std::ostream& operator<<(std::ostream& ostr, const Formula& e) { ostr << e.toSMTLIB(); return ostr; }
+    std::ostream& operator<<(std::ostream& ostr, const Formula& e);
     
 # pragma mark - Formulas
     
@@ -235,44 +242,45 @@ namespace logic {
     class Formulas
     {
     public:
-        static std::shared_ptr<const Formula> predicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "", bool noDeclaration=false);
-        static std::shared_ptr<const Formula> lemmaPredicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "");
+        static std::shared_ptr<const Formula> predicate(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "", bool noDeclaration=false);
+        static std::shared_ptr<const Formula> lemmaPredicate(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "");
         
-        static std::shared_ptr<const Formula> equality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
-        static std::shared_ptr<const Formula> disequality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
+        static std::shared_ptr<const Formula> equality(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label = "");
+        static std::shared_ptr<const Formula> disequality(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label = "");
 
-        static std::shared_ptr<const Formula> negation(std::shared_ptr<const Formula> f, std::string label = "");
+        static std::shared_ptr<const Formula> negation(const std::shared_ptr<const Formula>& f, std::string label = "");
 
         static std::shared_ptr<const Formula> conjunction(std::vector<std::shared_ptr<const Formula>> conj, std::string label = "");
         static std::shared_ptr<const Formula> disjunction(std::vector<std::shared_ptr<const Formula>> disj, std::string label = "");
         
-        static std::shared_ptr<const Formula> implication(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "");
-        static std::shared_ptr<const Formula> equivalence(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "");
+        static std::shared_ptr<const Formula> implication(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label = "");
+        static std::shared_ptr<const Formula> equivalence(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label = "");
         
-        static std::shared_ptr<const Formula> existential(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
-        static std::shared_ptr<const Formula> universal(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
+        static std::shared_ptr<const Formula> existential(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label = "");
+        static std::shared_ptr<const Formula> universal(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label = "");
 
         static std::shared_ptr<const Formula> trueFormula(std::string label = "");
         static std::shared_ptr<const Formula> falseFormula(std::string label = "");
 
         // variants of the above methods which additionally attempt to apply simplifications before generating the formulas
         // the label 'label' will be set on the result of the simplifications
-        static std::shared_ptr<const Formula> equalitySimp(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
-        static std::shared_ptr<const Formula> disequalitySimp(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
+        static std::shared_ptr<const Formula> equalitySimp(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label = "");
+        static std::shared_ptr<const Formula> disequalitySimp(const std::shared_ptr<const Term>& left, const std::shared_ptr<const Term>& right, std::string label = "");
 
-        static std::shared_ptr<const Formula> negationSimp(std::shared_ptr<const Formula> f, std::string label = "");
+        static std::shared_ptr<const Formula> negationSimp(const std::shared_ptr<const Formula>& f, std::string label = "");
 
         static std::shared_ptr<const Formula> conjunctionSimp(std::vector<std::shared_ptr<const Formula>> conj, std::string label = "");
         static std::shared_ptr<const Formula> disjunctionSimp(std::vector<std::shared_ptr<const Formula>> disj, std::string label = "");
         
-        static std::shared_ptr<const Formula> implicationSimp(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "");
-        static std::shared_ptr<const Formula> equivalenceSimp(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "");
+        static std::shared_ptr<const Formula> implicationSimp(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label = "");
+        static std::shared_ptr<const Formula> equivalenceSimp(const std::shared_ptr<const Formula>& f1, const std::shared_ptr<const Formula>& f2, std::string label = "");
         
-        static std::shared_ptr<const Formula> existentialSimp(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
-        static std::shared_ptr<const Formula> universalSimp(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
+        static std::shared_ptr<const Formula> existentialSimp(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label = "");
+        static std::shared_ptr<const Formula> universalSimp(std::vector<std::shared_ptr<const Symbol>> vars, const std::shared_ptr<const Formula>& f, std::string label = "");
 
     private:
-        static std::shared_ptr<const Formula> copyWithLabel(std::shared_ptr<const Formula> f, std::string label);
+        static std::shared_ptr<const Formula> copyWithLabel(const std::shared_ptr<const Formula>& f, std::string label);
+        static std::shared_ptr<const Symbol> fetchOrAddPredicateSymbol(const std::string& name, const std::vector<std::shared_ptr<const Term>>& subterms, bool isLemmaPredicate, bool noDeclaration);
     };
 }
 
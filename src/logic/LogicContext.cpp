@@ -0,0 +1,37 @@
+#include "LogicContext.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace logic {
+
+    thread_local LogicContext* LogicContext::_current = nullptr;
+
+    void LogicContext::reset()
+    {
+        // destroy the nodes in the same order as the destructor does.
+        // the tables are cleared instead of replaced, so that their buckets and capacities are reused by the next problem
+        terms.funcTerms.clear();
+        terms.vars.clear();
+        terms.nextId = 0;
+        signature.varSymbols.clear();
+        signature.signatureOrderedByInsertion.clear();
+        signature.signature.clear();
+        signature.nextId = 0;
+        sorts.sortsById.clear();
+        sorts.sorts.clear();
+        std::fill(std::begin(sorts.builtinSorts), std::end(sorts.builtinSorts), nullptr);
+        arena.reset();
+    }
+
+    LogicContext& LogicContext::current()
+    {
+        if (_current != nullptr)
+        {
+            return *_current;
+        }
+        // the global context is never destroyed, since nodes of it may still be referenced by other static objects
+        static LogicContext* globalContext = new LogicContext();
+        return *globalContext;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef __LogicContext__
+#define __LogicContext__
+
+#include "NodeArena.hpp"
+#include "Sort.hpp"
+#include "Signature.hpp"
+#include "Term.hpp"
+
+namespace logic {
+
+    /*
+     * the state of the manager-classes Sorts, Signature and Terms, together with the arena containing the nodes.
+     * each thread uses the context which is current for it, and by default all threads use a global context.
+     * independent problems can be processed in separate contexts (e.g. in parallel in separate threads), but nodes of
+     * different contexts must not be mixed, and all nodes of a context must be destroyed before the context.
+     */
+    class LogicContext
+    {
+    public:
+        LogicContext() : arena(), sorts(), signature(), terms() {}
+        LogicContext(const LogicContext&) = delete;
+        LogicContext& operator=(const LogicContext&) = delete;
+
+        static LogicContext& current();
+
+        // remove all sorts, symbols and terms (including the symbols of the theories), so that the context can be reused for an
+        // independent problem. The memory of the arena and of the tables is kept for the next problem. Must only be called if no
+        // other node of the context is alive.
+        void reset();
+
+        // makes the context current for the current thread during the lifetime of the scope
+        class Scope
+        {
+        public:
+            Scope(LogicContext& context) : previous(_current) { _current = &context; }
+            ~Scope() { _current = previous; }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            LogicContext* previous;
+        };
+
+        // note: the members are destroyed in reverse order, so the arena is destroyed after all nodes
+        NodeArena arena;
+        Sorts::State sorts;
+        Signature::State signature;
+        Terms::State terms;
+
+    private:
+        // the context set by the innermost scope of the current thread, or nullptr if the global context is used
+        static thread_local LogicContext* _current;
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "NodeArena.hpp"
+
+#include "LogicContext.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace logic {
+
+    NodeArena& NodeArena::instance()
+    {
+        return LogicContext::current().arena;
+    }
+
+    void* NodeArena::allocate(std::size_t size, std::size_t alignment)
+    {
+        allocated += size;
+
+        // nodes which don't fit into a chunk get their own chunk
+        if (size + alignment > chunkSize)
+        {
+            auto chunk = static_cast<char*>(std::malloc(size + alignment));
+            if (chunk == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            largeChunks.push_back(chunk);
+            return chunk + padding(chunk, alignment);
+        }
+
+        if (current == nullptr || padding(current, alignment) + size > remaining)
+        {
+            if (nextChunk == chunks.size())
+            {
+                auto chunk = static_cast<char*>(std::malloc(chunkSize));
+                if (chunk == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+                chunks.push_back(chunk);
+            }
+            current = chunks[nextChunk++];
+            remaining = chunkSize;
+        }
+        auto skip = padding(current, alignment);
+        auto result = current + skip;
+        current += skip + size;
+        remaining -= skip + size;
+        return result;
+    }
+
+    std::size_t NodeArena::padding(const char* address, std::size_t alignment)
+    {
+        return (alignment - reinterpret_cast<std::uintptr_t>(address) % alignment) % alignment;
+    }
+
+    void NodeArena::release()
+    {
+        reset();
+        for (const auto& chunk : chunks)
+        {
+            std::free(chunk);
+        }
+        chunks.clear();
+    }
+
+    void NodeArena::reset()
+    {
+        for (const auto& chunk : largeChunks)
+        {
+            std::free(chunk);
+        }
+        largeChunks.clear();
+        nextChunk = 0;
+        current = nullptr;
+        remaining = 0;
+        allocated = 0;
+    }
+}
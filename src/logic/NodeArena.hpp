@@ -0,0 +1,86 @@
+#ifndef __NodeArena__
+#define __NodeArena__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace logic {
+
+    /*
+     * bump allocator for the nodes of the logic, i.e. for symbols, terms and formulas.
+     * nodes are never freed individually (deallocation is a no-op). Instead the memory of all nodes is released at once.
+     * each LogicContext owns an arena, which is destroyed together with the nodes of the context.
+     */
+    class NodeArena
+    {
+    public:
+        NodeArena() : chunks(), largeChunks(), nextChunk(0), current(nullptr), remaining(0), allocated(0) {}
+        ~NodeArena() { release(); }
+        NodeArena(const NodeArena&) = delete;
+        NodeArena& operator=(const NodeArena&) = delete;
+
+        // the arena of the current LogicContext
+        static NodeArena& instance();
+
+        void* allocate(std::size_t size, std::size_t alignment);
+
+        // release the memory of all nodes at once. Must only be called if no node allocated in the arena is alive anymore.
+        void release();
+        // as release, but keep the chunks, so that they are reused by the following allocations
+        void reset();
+
+        // the number of bytes handed out since the last release (or reset)
+        std::size_t bytesAllocated() const { return allocated; }
+
+    private:
+        static const std::size_t chunkSize = 1 << 20;
+        // the number of bytes which need to be skipped to align 'address'
+        static std::size_t padding(const char* address, std::size_t alignment);
+
+        std::vector<char*> chunks;
+        // chunks of nodes which don't fit into a normal chunk
+        std::vector<char*> largeChunks;
+        // the index of the next chunk in 'chunks' which can be used
+        std::size_t nextChunk;
+        char* current;
+        std::size_t remaining;
+        std::size_t allocated;
+    };
+
+    // allocator used to construct nodes (together with the control block of their shared_ptr) inside the NodeArena.
+    // classes with private constructors need to declare NodeAllocator as friend.
+    template<typename T>
+    class NodeAllocator
+    {
+    public:
+        typedef T value_type;
+
+        NodeAllocator() noexcept {}
+        template<typename U> NodeAllocator(const NodeAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) { return static_cast<T*>(NodeArena::instance().allocate(n * sizeof(T), alignof(T))); }
+        void deallocate(T*, std::size_t) noexcept {}
+
+        template<typename U, typename... Args>
+        void construct(U* p, Args&&... args) { ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+        template<typename U>
+        void destroy(U* p) { p->~U(); }
+    };
+
+    template<typename T, typename U>
+    bool operator==(const NodeAllocator<T>&, const NodeAllocator<U>&) { return true; }
+    template<typename T, typename U>
+    bool operator!=(const NodeAllocator<T>&, const NodeAllocator<U>&) { return false; }
+
+    // construct a new node inside the NodeArena
+    template<typename T, typename... Args>
+    std::shared_ptr<const T> newNode(Args&&... args)
+    {
+        return std::allocate_shared<T>(NodeAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
+
+#endif
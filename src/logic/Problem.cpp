@@ -1,93 +1,451 @@
 #include "Problem.hpp"
 
 #include <algorithm>
+#include <cstdio>
 #include <ctime>
 #include <fstream>
+#include <future>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
+#include "SineSelection.hpp"
+#include "SMTLIBWriter.hpp"
+#include "TermSharing.hpp"
 #include "Output.hpp"
+#include "Hash.hpp"
+#include "LogicContext.hpp"
 #include "Options.hpp"
+#include "Statistics.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 
 namespace logic {
     
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const ProblemItem>>& f){ostr << "not implemented"; return ostr;}
 
-    void ReasoningTask::outputSMTLIBToDir(std::string dirPath, std::string preamble) const
+    thread_local const ItemOrigin* ItemOrigin::_current = nullptr;
+
+    const ItemOrigin& ItemOrigin::current()
+    {
+        static const ItemOrigin none;
+        return _current != nullptr ? *_current : none;
+    }
+
+    namespace
     {
-        auto outfileName = dirPath + conjecture->name + ".smt2";
+        // write 'content' to the file, unless the file already has exactly this content. Returns true iff the file was written.
+        bool writeIfChanged(const std::string& fileName, const std::string& content)
+        {
+            {
+                std::ifstream infile(fileName, std::ios::binary);
+                if (infile)
+                {
+                    std::string existingContent((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+                    if (existingContent == content)
+                    {
+                        return false;
+                    }
+                }
+            }
+            std::ofstream outfile(fileName, std::ios::binary);
+            outfile << content;
+            return true;
+        }
+
+        void outputAxiomSMTLIB(std::ostream& ostr, SMTLIBWriter& writer, const ProblemItem& axiom)
+        {
+            assert(axiom.type == ProblemItem::Type::Axiom || axiom.type == ProblemItem::Type::Definition);
+            if (axiom.name != "")
+            {
+                ostr << "\n; " << (axiom.type == ProblemItem::Type::Axiom ? "Axiom: " : "Definition: ") << axiom.name;
+            }
+            ostr << "\n(assert\n";
+            writer.write(*axiom.formula, 3);
+            ostr << "\n)\n";
+        }
+
+        void outputLogicSMTLIB(std::ostream& ostr)
+        {
+            auto smtlibLogic = "UFDTLIA"; // uninterpreted functions, datatypes and linear integer arithmetic
+            
+            // if encoding is used as smtlib-benchmark, add meta information
+            if(util::Configuration::instance().generateBenchmark())
+            {
+                ostr << "(set-info :smt-lib-version 2.6)\n";
+                ostr << "(set-logic " << smtlibLogic << ")\n";
+
+                std::time_t t = std::time(0);
+                std::tm* now = std::localtime(&t);
+
+                ostr << "(set-info :source |\n"
+                << "Generated by: Bernhard Gleiss\n"
+                << "Generated on: "
+                << (now->tm_year + 1900) << "-"
+                << (now->tm_mon + 1) << "-"
+                << now->tm_mday << "\n"
+                << "Generator: Rapid\n"
+                << "Application: Software Verification\n"
+                << "Target solver: Vampire\n"
+                << "|)\n"
+                << "(set-info :license \"https://creativecommons.org/licenses/by/4.0/\")\n"
+                << "(set-info :category crafted)\n"
+                << "(set-info :status unknown)\n\n";
+            }
+            else
+            {
+                ostr << "\n(set-logic " << smtlibLogic << ")\n\n";
+            }
+        }
+
+        // if relevantSymbols is given, only the symbols in it are declared
+        void outputDeclarationsSMTLIB(std::ostream& ostr, const std::unordered_set<const Symbol*>* relevantSymbols = nullptr)
+        {
+            // output sort declarations
+            for(const auto& pair : Sorts::nameToSort())
+            {
+                ostr << declareSortSMTLIB(*pair.second);
+            }
+            
+            // output symbol definitions
+            for (const auto& symbol : Signature::signatureOrderedByInsertion())
+            {
+                if (relevantSymbols == nullptr || relevantSymbols->find(symbol.get()) != relevantSymbols->end())
+                {
+                    ostr << symbol->declareSymbolSMTLIB();
+                }
+            }
+        }
+    }
+
+    bool ReasoningTask::outputSMTLIBToDir(const std::string& dirPath, const std::string& preamble, std::ostream& log) const
+    {
+        auto outfileName = outputFileName(dirPath);
         if(std::ifstream(outfileName))
         {
-            std::cout << "Error: The output-file " << outfileName << " already exists!" << std::endl;
-            exit(1);
+            log << "Error: The output-file " << outfileName << " already exists!" << std::endl;
+            return false;
         }
         
-        std::cout << "Generating reasoning task in " << outfileName << "\n";
-        std::ofstream outfile (outfileName);
-        
+        log << "Generating reasoning task in " << outfileName << "\n";
+        writeSMTLIBToFile(outfileName, preamble);
+        return true;
+    }
+
+    void ReasoningTask::writeSMTLIBToFile(const std::string& fileName, const std::string& preamble) const
+    {
+        std::ofstream outfile (fileName);
+        outputSMTLIB(outfile, preamble);
+        util::Statistics::addTask(fileName, outfile.tellp());
+    }
+
+    void ReasoningTask::outputSMTLIB(std::ostream& ostr, const std::string& preamble) const
+    {
+        util::Trace::Span span("task", util::Trace::isEnabled() ? conjecture->name : "");
         if(!util::Configuration::instance().generateBenchmark())
         {
-            outfile << preamble;
+            ostr << preamble;
         }
         
         // output task
-        outputSMTLIB(outfile);
+        outputSMTLIB(ostr);
     }
 
-    void ReasoningTask::outputSMTLIB(std::ostream& ostr) const
+    bool outputSMTLIBToDir(const std::vector<ReasoningTask>& tasks, const std::string& dirPath, const std::string& preamble, unsigned numberOfThreads, std::ostream& log)
     {
-        auto smtlibLogic = "UFDTLIA"; // uninterpreted functions, datatypes and linear integer arithmetic
-        
-        // if encoding is used as smtlib-benchmark, add meta information
-        if(util::Configuration::instance().generateBenchmark())
+        auto outputCache = util::Configuration::instance().outputCache();
+        if (numberOfThreads <= 1 && !outputCache)
+        {
+            for (const auto& task : tasks)
+            {
+                if (!task.outputSMTLIBToDir(dirPath, preamble, log))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // check all files (and report them in order) before writing any of them.
+        // in cache mode, the files are expected to exist already and are reported after they have been compared.
+        std::unordered_set<std::string> outfileNames;
+        for (const auto& task : tasks)
+        {
+            auto outfileName = task.outputFileName(dirPath);
+            if((!outputCache && std::ifstream(outfileName)) || !outfileNames.insert(outfileName).second)
+            {
+                log << "Error: The output-file " << outfileName << " already exists!" << std::endl;
+                return false;
+            }
+            if (!outputCache)
+            {
+                log << "Generating reasoning task in " << outfileName << "\n";
+            }
+        }
+
+        // in cache mode: the hash of the content of each task, and whether the file was written
+        std::vector<std::uint64_t> hashes(tasks.size());
+        std::vector<char> isWritten(tasks.size(), false);
+        auto outputTask = [&](unsigned i)
+        {
+            const auto& task = tasks[i];
+            if (!outputCache)
+            {
+                task.writeSMTLIBToFile(task.outputFileName(dirPath), preamble);
+                return;
+            }
+            std::stringstream content;
+            task.outputSMTLIB(content, preamble);
+            hashes[i] = util::contentHash(content.str());
+            util::Statistics::addTask(task.outputFileName(dirPath), content.str().size());
+            isWritten[i] = writeIfChanged(task.outputFileName(dirPath), content.str());
+        };
+
+        if (numberOfThreads <= 1)
         {
-            ostr << "(set-info :smt-lib-version 2.6)\n";
-            ostr << "(set-logic " << smtlibLogic << ")\n";
-
-            std::time_t t = std::time(0);
-            std::tm* now = std::localtime(&t);
-
-            ostr << "(set-info :source |\n"
-            << "Generated by: Bernhard Gleiss\n"
-            << "Generated on: "
-            << (now->tm_year + 1900) << "-"
-            << (now->tm_mon + 1) << "-"
-            << now->tm_mday << "\n"
-            << "Generator: Rapid\n"
-            << "Application: Software Verification\n"
-            << "Target solver: Vampire\n"
-            << "|)\n"
-            << "(set-info :license \"https://creativecommons.org/licenses/by/4.0/\")\n"
-            << "(set-info :category crafted)\n"
-            << "(set-info :status unknown)\n\n";
+            for (unsigned i = 0; i < tasks.size(); ++i)
+            {
+                outputTask(i);
+            }
         }
         else
         {
-            ostr << "\n(set-logic " << smtlibLogic << ")\n\n";
+            // the workers use the logic context and the configuration of the calling thread
+            auto& context = LogicContext::current();
+            auto& configuration = util::Configuration::instance();
+            std::vector<std::future<void>> results;
+            {
+                util::ThreadPool pool(numberOfThreads);
+                for (unsigned i = 0; i < tasks.size(); ++i)
+                {
+                    results.push_back(pool.submit([&outputTask, &context, &configuration, i]
+                    {
+                        LogicContext::Scope scope(context);
+                        util::Configuration::Scope configurationScope(configuration);
+                        outputTask(i);
+                    }));
+                }
+            }
+            for (auto& result : results)
+            {
+                result.get();
+            }
         }
-        
-        // output sort declarations
-        for(const auto& pair : Sorts::nameToSort())
+
+        if (outputCache)
         {
-            ostr << declareSortSMTLIB(*pair.second);
+            // remove the files of the tasks in the previous manifest which don't exist anymore (e.g. since a loop was renamed)
+            std::ifstream previousManifest(dirPath + "manifest.txt");
+            std::string line;
+            while (std::getline(previousManifest, line))
+            {
+                auto separator = line.find_last_of(' ');
+                if (separator == std::string::npos)
+                {
+                    continue;
+                }
+                auto outfileName = dirPath + line.substr(0, separator) + ".smt2";
+                if (outfileNames.find(outfileName) == outfileNames.end() && std::remove(outfileName.c_str()) == 0)
+                {
+                    log << "Removing stale reasoning task in " << outfileName << "\n";
+                }
+            }
+
+            // report the files and write the manifest, which maps each conjecture to the hash of its file
+            std::stringstream manifest;
+            for (unsigned i = 0; i < tasks.size(); ++i)
+            {
+                auto outfileName = tasks[i].outputFileName(dirPath);
+                log << (isWritten[i] ? "Generating reasoning task in " : "Unchanged reasoning task in ") << outfileName << "\n";
+                manifest << tasks[i].conjecture->name << " " << util::hashToString(hashes[i]) << "\n";
+            }
+            writeIfChanged(dirPath + "manifest.txt", manifest.str());
+        }
+        return true;
+    }
+
+    bool outputIncrementalSMTLIBToFile(const std::vector<ReasoningTask>& tasks, const std::string& fileName, const std::string& preamble, std::ostream& log)
+    {
+        // in cache mode, an existing script is only rewritten if its content changes
+        if (util::Configuration::instance().outputCache())
+        {
+            std::stringstream content;
+            outputIncrementalSMTLIB(tasks, content, preamble);
+            util::Statistics::addTask(fileName, content.str().size());
+            auto isWritten = writeIfChanged(fileName, content.str());
+            log << (isWritten ? "Generating incremental script for all reasoning tasks in " : "Unchanged incremental script for all reasoning tasks in ") << fileName << "\n";
+            return true;
+        }
+        if(std::ifstream(fileName))
+        {
+            log << "Error: The output-file " << fileName << " already exists!" << std::endl;
+            return false;
+        }
+        log << "Generating incremental script for all reasoning tasks in " << fileName << "\n";
+        std::ofstream ostr(fileName);
+        outputIncrementalSMTLIB(tasks, ostr, preamble);
+        util::Statistics::addTask(fileName, ostr.tellp());
+        return true;
+    }
+
+    void outputIncrementalSMTLIB(const std::vector<ReasoningTask>& tasks, std::ostream& ostr, const std::string& preamble)
+    {
+        if (tasks.empty())
+        {
+            return;
+        }
+        const auto& items = *tasks.front().items;
+        util::Trace::Span span("task", "incremental script");
+
+        // each axiom is asserted right before the first task which uses the axiom or a later axiom (so the axioms keep their order).
+        // an axiom which is used by this task and all following tasks is asserted as it is, any other axiom is guarded
+        // by a boolean constant, which is assumed only inside the checks of the tasks using the axiom.
+        std::vector<std::vector<unsigned>> indicesOfTask;
+        std::vector<unsigned> numberOfTasksUsing(items.asAxioms.size(), 0);
+        std::vector<unsigned> firstTaskAsserting(items.asAxioms.size(), tasks.size());
+        unsigned numberOfAsserted = 0;
+        for (unsigned t = 0; t < tasks.size(); ++t)
+        {
+            assert(tasks[t].items.get() == &items);
+            indicesOfTask.push_back(tasks[t].selectedAxiomIndices());
+            for (const auto& index : indicesOfTask.back())
+            {
+                numberOfTasksUsing[index]++;
+                for (; numberOfAsserted <= index; ++numberOfAsserted)
+                {
+                    firstTaskAsserting[numberOfAsserted] = t;
+                }
+            }
+        }
+        auto isGuarded = [&](unsigned index) { return numberOfTasksUsing[index] < tasks.size() - firstTaskAsserting[index]; };
+        auto guardName = [](unsigned index) { return "item!" + std::to_string(index); };
+
+        if(!util::Configuration::instance().generateBenchmark())
+        {
+            ostr << preamble;
+        }
+        outputLogicSMTLIB(ostr);
+        outputDeclarationsSMTLIB(ostr);
+
+        SMTLIBWriter writer(ostr);
+        numberOfAsserted = 0;
+        for (unsigned t = 0; t < tasks.size(); ++t)
+        {
+            // assert the axioms which are needed the first time
+            for (; numberOfAsserted < items.asAxioms.size() && firstTaskAsserting[numberOfAsserted] == t; ++numberOfAsserted)
+            {
+                const auto& axiom = items.asAxioms[numberOfAsserted];
+                if (axiom == nullptr)
+                {
+                    continue;
+                }
+                if (!isGuarded(numberOfAsserted))
+                {
+                    ostr << items.renderedAxiom(numberOfAsserted);
+                    continue;
+                }
+                if (axiom->name != "")
+                {
+                    ostr << "\n; " << (axiom->type == ProblemItem::Type::Axiom ? "Axiom: " : "Definition: ") << axiom->name;
+                }
+                ostr << "\n(declare-fun " << guardName(numberOfAsserted) << " () Bool)\n";
+                ostr << "(assert\n   (=>\n      " << guardName(numberOfAsserted) << "\n";
+                writer.write(*axiom->formula, 6);
+                ostr << "\n   )\n)\n";
+            }
+
+            // check the conjecture in its own scope, using exactly the axioms of the task
+            const auto& conjecture = *tasks[t].conjecture;
+            ostr << "\n(push 1)\n";
+            for (const auto& index : indicesOfTask[t])
+            {
+                if (isGuarded(index))
+                {
+                    ostr << "(assert " << guardName(index) << ")\n";
+                }
+            }
+            if (conjecture.name != "")
+            {
+                ostr << "\n; Conjecture: " << conjecture.name;
+            }
+            ostr << "\n(assert\n   (not\n";
+            writer.write(*conjecture.formula, 6);
+            ostr << "\n   )\n)\n";
+            ostr << "(check-sat)\n(pop 1)\n";
         }
+    }
+
+    void ReasoningTask::outputSMTLIB(std::ostream& ostr) const
+    {
+        auto indices = selectedAxiomIndices();
         
-        // output symbol definitions
-        for (const auto& symbol : Signature::signatureOrderedByInsertion())
+        outputLogicSMTLIB(ostr);
+        if (util::Configuration::instance().sine())
+        {
+            // only declare the symbols occurring in the output
+            std::unordered_set<const Symbol*> relevantSymbols;
+            for (const auto& index : indices)
+            {
+                const auto& symbols = items->symbolsOf(index);
+                relevantSymbols.insert(symbols.begin(), symbols.end());
+            }
+            for (const auto& symbol : SineSelection::symbols(*conjecture->formula))
+            {
+                relevantSymbols.insert(symbol);
+            }
+            outputDeclarationsSMTLIB(ostr, &relevantSymbols);
+        }
+        else
         {
-            ostr << symbol->declareSymbolSMTLIB();
+            outputDeclarationsSMTLIB(ostr);
         }
         
-        // output each axiom
-        for (const auto& axiom : axioms)
+        // if enabled, print repeated subterms only once
+        auto sharing = termSharing(indices);
+        SMTLIBWriter writer = sharing ? SMTLIBWriter(ostr, *sharing) : SMTLIBWriter(ostr);
+        if (sharing && !sharing->closedTerms().empty())
+        {
+            ostr << "\n; shared terms\n";
+            writer.writeDefinitions();
+        }
+
+        // output each axiom.
+        // without term sharing the text of an axiom doesn't depend on the task, so the cached text is used.
+        for (const auto& index : indices)
         {
-            assert(axiom->type == ProblemItem::Type::Axiom || axiom->type == ProblemItem::Type::Definition);
-            if (axiom->name != "")
+            if (sharing)
             {
-                ostr << "\n; " << (axiom->type == ProblemItem::Type::Axiom ? "Axiom: " : "Definition: ") << axiom->name;
+                outputAxiomSMTLIB(ostr, writer, *items->asAxioms[index]);
+            }
+            else
+            {
+                ostr << items->renderedAxiom(index);
             }
-            ostr << "\n(assert\n" << axiom->formula->toSMTLIB(3) + "\n)\n";
         }
         
-        // output conjecture
+        outputConjectureSMTLIB(ostr, writer);
+
+        ostr << "\n(check-sat)\n" << std::endl;
+    }
+    
+    std::unique_ptr<TermSharing> ReasoningTask::termSharing(const std::vector<unsigned>& indices) const
+    {
+        if (!util::Configuration::instance().shareTerms())
+        {
+            return nullptr;
+        }
+        std::vector<const Formula*> formulas;
+        for (const auto& index : indices)
+        {
+            formulas.push_back(items->asAxioms[index]->formula.get());
+        }
+        formulas.push_back(conjecture->formula.get());
+        return std::unique_ptr<TermSharing>(new TermSharing(formulas));
+    }
+
+    void ReasoningTask::outputConjectureSMTLIB(std::ostream& ostr, SMTLIBWriter& writer) const
+    {
         assert(conjecture != nullptr);
         
         // if benchmark is used as smtlib-benchmark, replace (assert-not F) by (assert (not F))
@@ -96,8 +454,10 @@ namespace logic {
             ostr
             << "\n; negated conjecture\n"
             << "(assert\n"
-            << "   (not\n"
-            <<         conjecture->formula->toSMTLIB(6) << "\n"
+            << "   (not\n";
+            writer.write(*conjecture->formula, 6);
+            ostr
+            << "\n"
             << "   )\n"
             << ")\n";
         }
@@ -107,74 +467,214 @@ namespace logic {
             {
                 ostr << "\n; Conjecture: " << conjecture->name;
             }
-            ostr << "\n(assert-not\n" << conjecture->formula->toSMTLIB(3) + "\n)\n";
+            ostr << "\n(assert-not\n";
+            writer.write(*conjecture->formula, 3);
+            ostr << "\n)\n";
         }
+    }
 
-        ostr << "\n(check-sat)\n" << std::endl;
+    std::string ReasoningTask::renderedConjecture() const
+    {
+        // with term sharing, the conjecture refers to the shared terms defined at the beginning of the task
+        std::stringstream ostr;
+        auto sharing = termSharing(selectedAxiomIndices());
+        SMTLIBWriter writer = sharing ? SMTLIBWriter(ostr, *sharing) : SMTLIBWriter(ostr);
+        if (sharing && !sharing->closedTerms().empty())
+        {
+            writer.writeDefinitions();
+        }
+        auto begin = ostr.str().size();
+        outputConjectureSMTLIB(ostr, writer);
+        return ostr.str().substr(begin);
+    }
+
+    ProblemItemSequence::ProblemItemSequence(const std::vector<std::shared_ptr<const ProblemItem>>& items)
+    {
+        for (unsigned i = 0; i < items.size(); ++i)
+        {
+            const auto& item = items[i];
+            switch (item->type)
+            {
+                case ProblemItem::Type::Axiom:
+                case ProblemItem::Type::Definition:
+                {
+                    asAxioms.push_back(item);
+                    break;
+                }
+                case ProblemItem::Type::Lemma:
+                {
+                    // the wrapped lemma keeps the origin of the lemma
+                    ItemOrigin::Scope originScope(item->origin);
+                    asAxioms.push_back(std::make_shared<Axiom>(item->formula, "already-proven-lemma " + item->name));
+                    break;
+                }
+                default:
+                {
+                    asAxioms.push_back(nullptr);
+                    continue;
+                }
+            }
+            if (item->visibility == ProblemItem::Visibility::All || item->visibility == ProblemItem::Visibility::Implicit)
+            {
+                implicitlyVisible.push_back(i);
+            }
+            if (item->visibility == ProblemItem::Visibility::All)
+            {
+                explicitlyVisible.push_back(i);
+            }
+        }
+        renderedAxioms.resize(asAxioms.size());
+        isRendered.reset(new std::once_flag[asAxioms.size()]);
+        axiomSymbols.resize(asAxioms.size());
+        areSymbolsComputed.reset(new std::once_flag[asAxioms.size()]);
+    }
+
+    const std::string& ProblemItemSequence::renderedAxiom(unsigned index) const
+    {
+        assert(asAxioms[index] != nullptr);
+        std::call_once(isRendered[index], [this, index]
+        {
+            std::stringstream ostr;
+            SMTLIBWriter writer(ostr);
+            outputAxiomSMTLIB(ostr, writer, *asAxioms[index]);
+            renderedAxioms[index] = ostr.str();
+        });
+        return renderedAxioms[index];
+    }
+
+    const std::vector<const Symbol*>& ProblemItemSequence::symbolsOf(unsigned index) const
+    {
+        assert(asAxioms[index] != nullptr);
+        std::call_once(areSymbolsComputed[index], [this, index]
+        {
+            axiomSymbols[index] = SineSelection::symbols(*asAxioms[index]->formula);
+        });
+        return axiomSymbols[index];
+    }
+
+    std::vector<unsigned> ReasoningTask::selectedAxiomIndices() const
+    {
+        auto indices = axiomIndices();
+        if (!util::Configuration::instance().sine())
+        {
+            return indices;
+        }
+        std::vector<const std::vector<const Symbol*>*> axiomSymbols;
+        for (const auto& index : indices)
+        {
+            axiomSymbols.push_back(&items->symbolsOf(index));
+        }
+        SineSelection selection(axiomSymbols, SineSelection::symbols(*conjecture->formula), util::Configuration::instance().sineDepth());
+
+        std::vector<unsigned> result;
+        for (unsigned i = 0; i < indices.size(); ++i)
+        {
+            if (selection.isSelected(i))
+            {
+                result.push_back(indices[i]);
+            }
+        }
+        return result;
+    }
+
+    std::vector<unsigned> ReasoningTask::axiomIndices() const
+    {
+        std::vector<unsigned> result;
+        const auto& visible = explicitMode ? items->explicitlyVisible : items->implicitlyVisible;
+        result.reserve(numberOfVisibleItems + additionalItems.size());
+
+        // merge the visible items with the additional items, both are ordered by index
+        unsigned i = 0;
+        unsigned j = 0;
+        while (i < numberOfVisibleItems || j < additionalItems.size())
+        {
+            if (j == additionalItems.size() || (i < numberOfVisibleItems && visible[i] < additionalItems[j]))
+            {
+                result.push_back(visible[i++]);
+            }
+            else
+            {
+                result.push_back(additionalItems[j++]);
+            }
+        }
+        return result;
+    }
+
+    std::vector<const ProblemItem*> ReasoningTask::axioms() const
+    {
+        std::vector<const ProblemItem*> result;
+        for (const auto& index : axiomIndices())
+        {
+            result.push_back(items->asAxioms[index].get());
+        }
+        return result;
     }
     
     std::vector<ReasoningTask> Problem::generateReasoningTasks() const
     {
         std::vector<ReasoningTask> tasks;
+        auto sequence = std::make_shared<const ProblemItemSequence>(items);
+
+        // for explicit mode: the indices of the items which are only used if referenced by name
+        std::unordered_map<std::string, std::vector<unsigned>> hiddenItemsByName;
+
+        // the number of implicitly/explicitly visible items among the items preceding the current item
+        unsigned numberOfImplicitlyVisible = 0;
+        unsigned numberOfExplicitlyVisible = 0;
 
-        for (int i = 0; i < items.size(); ++i)
+        for (unsigned i = 0; i < items.size(); ++i)
         {
-            auto item = items[i];
+            const auto& item = items[i];
 
             // if the item is a lemma or conjecture, generate a new reasoning task to prove that lemma/conjecture
             if (item->type == ProblemItem::Type::Lemma || item->type == ProblemItem::Type::Conjecture)
             {
-                // collect all previous axioms, which are not hidden or occur in fromItems
-                std::vector<std::shared_ptr<const ProblemItem>> currentAxioms;
-                for (int j = 0; j < i; ++j)
-                {
-                    auto curr = items[j];
+                // add item as conjecture, keeping the origin of the item
+                ItemOrigin::Scope originScope(item->origin);
+                auto conjecture = std::make_shared<Conjecture>(item->formula, item->name);
 
-                    if (item->fromItems.empty())
-                    {
-                        // implicit mode: collect all axioms visible for implicit mode
-                        if ((curr->type == ProblemItem::Type::Axiom || curr->type == ProblemItem::Type::Definition))
-                        {
-                            if(curr->visibility == ProblemItem::Visibility::All || curr->visibility == ProblemItem::Visibility::Implicit)
-                            {
-                                currentAxioms.push_back(curr);
-                            }
-                        }
-                        else if (curr->type == ProblemItem::Type::Lemma)
-                        {
-                            if(curr->visibility == ProblemItem::Visibility::All || curr->visibility == ProblemItem::Visibility::Implicit)
-                            {
-                                currentAxioms.push_back(std::make_shared<Axiom>(curr->formula, "already-proven-lemma " + curr->name));
-                            }
-                        }
-                    }
-                    else 
+                if (item->fromItems.empty())
+                {
+                    // implicit mode: use all previous axioms visible for implicit mode
+                    tasks.push_back(ReasoningTask(sequence, false, numberOfImplicitlyVisible, {}, conjecture));
+                }
+                else
+                {
+                    // explicit mode: use all previous axioms, which are either visible for explicit mode or occur in fromItems
+                    std::vector<unsigned> additionalItems;
+                    for (const auto& name : item->fromItems)
                     {
-                        // explicit mode: collect all axioms, which are either visible for explicit mode or occur in fromItems
-                        if (curr->visibility == ProblemItem::Visibility::All || std::find(item->fromItems.begin(), item->fromItems.end(), curr->name) != item->fromItems.end())
+                        auto it = hiddenItemsByName.find(name);
+                        if (it != hiddenItemsByName.end())
                         {
-                            if ((curr->type == ProblemItem::Type::Axiom || curr->type == ProblemItem::Type::Definition))
-                            {
-                                currentAxioms.push_back(curr);
-                            }
-                            else if (curr->type == ProblemItem::Type::Lemma)
-                            {
-                                currentAxioms.push_back(std::make_shared<Axiom>(curr->formula, "already-proven-lemma " + curr->name));
-                            }
+                            additionalItems.insert(additionalItems.end(), it->second.begin(), it->second.end());
                         }
                     }
+                    std::sort(additionalItems.begin(), additionalItems.end());
+                    additionalItems.erase(std::unique(additionalItems.begin(), additionalItems.end()), additionalItems.end());
+
+                    // sanity check: all axioms must have been found (note: there could be other axioms too)
+                    assert(item->fromItems.size() <= numberOfExplicitlyVisible + additionalItems.size());
+
+                    tasks.push_back(ReasoningTask(sequence, true, numberOfExplicitlyVisible, std::move(additionalItems), conjecture));
                 }
+            }
 
-                // sanity check: if explicit mode is used, all axioms must have been found (note: there could be other axioms too)
-                if (!item->fromItems.empty())
+            // update the visible items for the tasks of the following items
+            if (sequence->asAxioms[i] != nullptr)
+            {
+                if (item->visibility == ProblemItem::Visibility::All || item->visibility == ProblemItem::Visibility::Implicit)
                 {
-                    assert(item->fromItems.size() <= currentAxioms.size());
+                    numberOfImplicitlyVisible++;
+                }
+                if (item->visibility == ProblemItem::Visibility::All)
+                {
+                    numberOfExplicitlyVisible++;
+                }
+                else
+                {
+                    hiddenItemsByName[item->name].push_back(i);
                 }
-
-                // add item as conjecture
-                auto conjecture = std::make_shared<Conjecture>(item->formula, item->name);
-                auto task = ReasoningTask(currentAxioms, conjecture);
-                tasks.push_back(task);
             }
         }
         return tasks;
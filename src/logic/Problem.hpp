@@ -4,6 +4,7 @@
 #include <cassert>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,6 +13,50 @@
 #include "Problem.hpp"
 
 namespace logic {
+
+    /*
+     * where a problem item comes from: the generator of the item (e.g. "ValueEvolutionLemmas"), the kind of the item
+     * (e.g. "inductionAxiom1" for the items of an induction axiom, empty otherwise), and the loop (as location) and the
+     * variable the item is about (empty if the item is not about a single loop or variable).
+     * each item takes the origin which is current for the calling thread when the item is constructed.
+     */
+    class ItemOrigin
+    {
+    public:
+        std::string generator;
+        std::string kind;
+        std::string location;
+        std::string variable;
+
+        // the current origin with one part replaced
+        ItemOrigin withGenerator(std::string generator) const { auto origin = *this; origin.generator = std::move(generator); return origin; }
+        ItemOrigin withKind(std::string kind) const { auto origin = *this; origin.kind = std::move(kind); return origin; }
+        ItemOrigin withLocation(std::string location) const { auto origin = *this; origin.location = std::move(location); return origin; }
+        ItemOrigin withVariable(std::string variable) const { auto origin = *this; origin.variable = std::move(variable); return origin; }
+
+        // the origin which is current for the current thread, by default the empty origin
+        static const ItemOrigin& current();
+
+        // makes the origin current for the current thread during the lifetime of the scope
+        class Scope;
+
+    private:
+        static thread_local const ItemOrigin* _current;
+    };
+
+    class ItemOrigin::Scope
+    {
+    public:
+        Scope(ItemOrigin origin) : origin(std::move(origin)), previous(_current) { _current = &this->origin; }
+        ~Scope() { _current = previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const ItemOrigin origin;
+        const ItemOrigin* previous;
+    };
     
     /*
      * abstract class for wrapping a formula and tagging it as either axiom, definition, lemma or conjecture
@@ -22,7 +67,7 @@ namespace logic {
         enum class Type { Program, Axiom, Definition, Lemma, Conjecture};
         enum class Visibility { All, Implicit, None};
         
-        ProblemItem(Type type, std::shared_ptr<const logic::Formula> formula, std::string name, Visibility visibility, std::vector<std::string> fromItems) : type(type), formula(formula), name(name), visibility(visibility), fromItems(fromItems)
+        ProblemItem(Type type, std::shared_ptr<const logic::Formula> formula, std::string name, Visibility visibility, std::vector<std::string> fromItems) : type(type), formula(formula), name(name), visibility(visibility), fromItems(fromItems), origin(ItemOrigin::current())
         {
             // it doesn't make sense to hide conjectures
             if (type == Type::Conjecture)
@@ -52,6 +97,7 @@ namespace logic {
         const std::string name;
         const Visibility visibility;
         const std::vector<std::string> fromItems;
+        const ItemOrigin origin;
     };
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
@@ -86,25 +132,116 @@ namespace logic {
             ProblemItem(ProblemItem::Type::Conjecture, conjecture, name, ProblemItem::Visibility::All, fromItems) {}
     };
     
+    /*
+     * the items of a problem, prepared for being shared by all reasoning tasks of the problem:
+     * each lemma is wrapped as axiom only once, and for each visibility-mode the indices of the visible items are precomputed.
+     */
+    class ProblemItemSequence
+    {
+    public:
+        ProblemItemSequence(const std::vector<std::shared_ptr<const ProblemItem>>& items);
+
+        // asAxioms[i] is the i-th item of the problem as it is used in the reasoning tasks of later items, i.e.
+        // axioms and definitions are used directly, lemmas are wrapped as axiom and conjectures are not used (nullptr).
+        std::vector<std::shared_ptr<const ProblemItem>> asAxioms;
+        // the indices (in increasing order) of the items which are used as axioms if no fromItems are given (implicit mode)
+        std::vector<unsigned> implicitlyVisible;
+        // the indices (in increasing order) of the items which are used as axioms in any case if fromItems are given (explicit mode)
+        std::vector<unsigned> explicitlyVisible;
+
+        // the SMTLIB-text of asAxioms[index]. The text is rendered when it is needed for the first time and afterwards reused by all tasks.
+        const std::string& renderedAxiom(unsigned index) const;
+
+        // the declared symbols of asAxioms[index], computed when they are needed for the first time
+        const std::vector<const Symbol*>& symbolsOf(unsigned index) const;
+
+    private:
+        // the text and the symbols are computed at most once, even if several tasks are output concurrently
+        mutable std::vector<std::string> renderedAxioms;
+        std::unique_ptr<std::once_flag[]> isRendered;
+        mutable std::vector<std::vector<const Symbol*>> axiomSymbols;
+        std::unique_ptr<std::once_flag[]> areSymbolsComputed;
+    };
+
+    class SMTLIBWriter;
+    class TermSharing;
+
     // represents a first-order reasoning task which can be passed to a prover.
+    // the axioms of the task are a view on the items of the problem: they consist of a prefix of the items visible in the
+    // mode of the task, together with the additional items referenced by name (in explicit mode).
     // for now sorts and signatures are not part of Problem, maybe should be refactored.
     class ReasoningTask
     {
     public:
-        ReasoningTask(std::vector<std::shared_ptr<const ProblemItem>> axioms, std::shared_ptr<const Conjecture> conjecture) : axioms(axioms), conjecture(conjecture) {}
+        ReasoningTask(std::shared_ptr<const ProblemItemSequence> items, bool explicitMode, unsigned numberOfVisibleItems, std::vector<unsigned> additionalItems, std::shared_ptr<const Conjecture> conjecture) :
+            conjecture(std::move(conjecture)), items(std::move(items)), explicitMode(explicitMode), numberOfVisibleItems(numberOfVisibleItems), additionalItems(std::move(additionalItems)) {}
         
-        const std::vector<std::shared_ptr<const ProblemItem>> axioms;
         const std::shared_ptr<const Conjecture> conjecture;
 
+        // the axioms of the task, in the order in which they occur in the problem
+        std::vector<const ProblemItem*> axioms() const;
+
         /*
          * generate a new file in the directory 'dirPath' and output the reasoning task in SMTLIB syntax.
-         * the preamble string is added at the beginning of the file.
+         * the preamble string is added at the beginning of the file. Progress and error messages are written to 'log'.
+         * returns false (without writing anything) if the file already exists.
          */
-        void outputSMTLIBToDir(std::string dirPath, std::string preamble) const;
+        bool outputSMTLIBToDir(const std::string& dirPath, const std::string& preamble, std::ostream& log = std::cout) const;
+
+        // output the content of the file of the task (i.e. the preamble, unless a benchmark is generated, followed by the task) to 'ostr'
+        void outputSMTLIB(std::ostream& ostr, const std::string& preamble) const;
+
+        // the file in the directory 'dirPath' to which the reasoning task is output
+        std::string outputFileName(const std::string& dirPath) const { return dirPath + conjecture->name + ".smt2"; }
         
     private:
+        const std::shared_ptr<const ProblemItemSequence> items;
+        const bool explicitMode;
+        // the number of items of items->implicitlyVisible (resp. items->explicitlyVisible) used by the task
+        const unsigned numberOfVisibleItems;
+        // the indices (in increasing order) of the items which are not visible in explicit mode, but occur in fromItems
+        const std::vector<unsigned> additionalItems;
+
+        // the indices of the axioms of the task, in increasing order
+        std::vector<unsigned> axiomIndices() const;
+        // the indices of the axioms which are output, i.e. the axioms of the task which are relevant if the relevance filter is enabled
+        std::vector<unsigned> selectedAxiomIndices() const;
         void outputSMTLIB(std::ostream& ostr) const;
+        // the term sharing for the axioms with the given indices and the conjecture, or nullptr if terms are not shared
+        std::unique_ptr<TermSharing> termSharing(const std::vector<unsigned>& indices) const;
+        // output the (negated) conjecture, as the last item of the task
+        void outputConjectureSMTLIB(std::ostream& ostr, SMTLIBWriter& writer) const;
+        // the text of the conjecture, as it is output in the task
+        std::string renderedConjecture() const;
+        void writeSMTLIBToFile(const std::string& fileName, const std::string& preamble) const;
+
+        friend bool outputSMTLIBToDir(const std::vector<ReasoningTask>& tasks, const std::string& dirPath, const std::string& preamble, unsigned numberOfThreads, std::ostream& log);
+        friend void outputIncrementalSMTLIB(const std::vector<ReasoningTask>& tasks, std::ostream& ostr, const std::string& preamble);
+        friend void outputSizeReport(const std::vector<ReasoningTask>& tasks, std::ostream& ostr);
     };
+
+    /*
+     * output each of the tasks as in ReasoningTask::outputSMTLIBToDir, using 'numberOfThreads' threads.
+     * the content of each file doesn't depend on the number of threads.
+     * if the output cache is enabled, existing files whose content is unchanged are not touched, and a file
+     * manifest.txt is written which maps the name of each conjecture to the hash of the content of its file. The files of
+     * the tasks in the previous manifest which are not generated anymore are removed.
+     * returns false if one of the files already exists (unless the output cache is enabled).
+     */
+    bool outputSMTLIBToDir(const std::vector<ReasoningTask>& tasks, const std::string& dirPath, const std::string& preamble, unsigned numberOfThreads, std::ostream& log = std::cout);
+
+    /*
+     * output all tasks (which must be generated by the same problem) into a single SMTLIB-script for incremental solvers:
+     * the signature is declared once, the axioms are asserted once and each conjecture is checked inside (push)/(pop).
+     * the set of axioms used to check each conjecture is the same as in the output of the task on its own
+     * (only the declarations are not filtered by relevance).
+     * the preamble string is added at the beginning of the file. Returns false if the file already exists, unless the
+     * output cache is enabled, in which case the existing file is only rewritten if its content changes.
+     */
+    bool outputIncrementalSMTLIBToFile(const std::vector<ReasoningTask>& tasks, const std::string& fileName, const std::string& preamble, std::ostream& log = std::cout);
+
+    // output the script of outputIncrementalSMTLIBToFile to 'ostr'
+    void outputIncrementalSMTLIB(const std::vector<ReasoningTask>& tasks, std::ostream& ostr, const std::string& preamble);
     
     /* represents a list of axioms, lemmas and conjectures,
      * where each lemma and each conjecture needs to be proven
@@ -0,0 +1,300 @@
+#include "SMTLIBWriter.hpp"
+
+#include <cassert>
+#include <string>
+
+namespace logic {
+
+    void SMTLIBWriter::write(const Term& t)
+    {
+        pushTerm(t);
+        run();
+    }
+
+    void SMTLIBWriter::write(const Formula& f, unsigned indentation)
+    {
+        letsEnabled = sharing != nullptr && !sharing->isExcluded(f);
+        pushFormula(f, indentation);
+        run();
+    }
+
+    void SMTLIBWriter::writeDefinitions()
+    {
+        assert(sharing != nullptr);
+        for (const auto& t : sharing->closedTerms())
+        {
+            ostr << "(define-fun " << TermSharing::name(*t) << " () " << t->symbol->rngSort->toSMTLIB() << " ";
+            stack.push_back({Item::Kind::Definition, t, nullptr, 0});
+            run();
+            ostr << ")\n";
+            activeTerms.insert(t);
+        }
+    }
+
+    void SMTLIBWriter::run()
+    {
+        while (!stack.empty())
+        {
+            auto item = stack.back();
+            stack.pop_back();
+
+            switch (item.kind)
+            {
+                case Item::Kind::Term:
+                {
+                    process(*static_cast<const Term*>(item.node));
+                    break;
+                }
+                case Item::Kind::Formula:
+                {
+                    process(*static_cast<const Formula*>(item.node), item.indentation);
+                    break;
+                }
+                case Item::Kind::Text:
+                {
+                    writeIndentation(item.indentation);
+                    ostr << item.text;
+                    break;
+                }
+                case Item::Kind::Definition:
+                {
+                    processDefinition(*static_cast<const Term*>(item.node));
+                    break;
+                }
+                case Item::Kind::LetOpen:
+                {
+                    writeIndentation(item.indentation);
+                    ostr << "(let ((" << TermSharing::name(*static_cast<const Term*>(item.node)) << " ";
+                    break;
+                }
+                case Item::Kind::Activate:
+                {
+                    activeTerms.insert(static_cast<const Term*>(item.node));
+                    break;
+                }
+                case Item::Kind::LetClose:
+                {
+                    const auto& terms = sharing->letTerms(*static_cast<const Formula*>(item.node));
+                    ostr << "\n";
+                    writeIndentation(item.indentation);
+                    for (const auto& t : terms)
+                    {
+                        ostr << ")";
+                        activeTerms.erase(t);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void SMTLIBWriter::pushTerms(const std::vector<std::shared_ptr<const Term>>& terms)
+    {
+        // items are popped in reverse order, so push the closing parenthesis first
+        pushText(")");
+        for (unsigned i = terms.size(); i-- > 0;)
+        {
+            pushTerm(*terms[i]);
+            if (i > 0)
+            {
+                pushText(" ");
+            }
+        }
+    }
+
+    void SMTLIBWriter::pushLets(const Formula& f, const Formula& subformula, unsigned indentation)
+    {
+        const auto& terms = sharing->letTerms(f);
+        stack.push_back({Item::Kind::LetClose, &f, nullptr, indentation});
+        pushFormula(subformula, indentation);
+        for (unsigned i = terms.size(); i-- > 0;)
+        {
+            stack.push_back({Item::Kind::Activate, terms[i], nullptr, 0});
+            pushText("))\n");
+            stack.push_back({Item::Kind::Definition, terms[i], nullptr, 0});
+            stack.push_back({Item::Kind::LetOpen, terms[i], nullptr, indentation});
+        }
+    }
+
+    void SMTLIBWriter::process(const Term& t)
+    {
+        if (!activeTerms.empty() && activeTerms.find(&t) != activeTerms.end())
+        {
+            ostr << TermSharing::name(t);
+        }
+        else
+        {
+            processDefinition(t);
+        }
+    }
+
+    void SMTLIBWriter::processDefinition(const Term& t)
+    {
+        if (t.type() == Term::Type::Variable)
+        {
+            ostr << t.symbol->name;
+        }
+        else
+        {
+            assert(t.type() == Term::Type::FuncTerm);
+            auto& castedTerm = static_cast<const FuncTerm&>(t);
+            if (castedTerm.subterms.size() == 0)
+            {
+                ostr << castedTerm.symbol->toSMTLIB();
+            }
+            else
+            {
+                ostr << "(" << castedTerm.symbol->toSMTLIB() << " ";
+                pushTerms(castedTerm.subterms);
+            }
+        }
+    }
+
+    void SMTLIBWriter::process(const Formula& f, unsigned indentation)
+    {
+        switch (f.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                auto& castedFormula = static_cast<const PredicateFormula&>(f);
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                if (castedFormula.subterms.size() == 0)
+                {
+                    ostr << castedFormula.symbol->toSMTLIB();
+                }
+                else
+                {
+                    ostr << "(" << castedFormula.symbol->toSMTLIB() << " ";
+                    pushTerms(castedFormula.subterms);
+                }
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedFormula = static_cast<const EqualityFormula&>(f);
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                ostr << (castedFormula.polarity ? "(= " : "(not (= ");
+                pushText(castedFormula.polarity ? ")" : "))");
+                pushTerm(*castedFormula.right);
+                pushText(" ");
+                pushTerm(*castedFormula.left);
+                break;
+            }
+            case Formula::Type::Conjunction:
+            case Formula::Type::Disjunction:
+            {
+                bool isConjunction = f.type() == Formula::Type::Conjunction;
+                const auto& subformulas = isConjunction ? static_cast<const ConjunctionFormula&>(f).conj : static_cast<const DisjunctionFormula&>(f).disj;
+                if (subformulas.size() == 0)
+                {
+                    writeLabel(f, indentation);
+                    writeIndentation(indentation);
+                    ostr << (isConjunction ? "true" : "false");
+                    break;
+                }
+                // note: the label of a non-empty disjunction has never been part of the output, so we keep it that way
+                if (isConjunction)
+                {
+                    writeLabel(f, indentation);
+                }
+                writeIndentation(indentation);
+                ostr << (isConjunction ? "(and\n" : "(or\n");
+                pushText(")", indentation);
+                for (unsigned i = subformulas.size(); i-- > 0;)
+                {
+                    pushText("\n");
+                    pushFormula(*subformulas[i], indentation + 3);
+                }
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                auto& castedFormula = static_cast<const NegationFormula&>(f);
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                ostr << "(not\n";
+                pushText(")", indentation);
+                pushText("\n");
+                pushFormula(*castedFormula.f, indentation + 3);
+                break;
+            }
+            case Formula::Type::Existential:
+            case Formula::Type::Universal:
+            {
+                bool isExistential = f.type() == Formula::Type::Existential;
+                const auto& vars = isExistential ? static_cast<const ExistentialFormula&>(f).vars : static_cast<const UniversalFormula&>(f).vars;
+                const auto& subformula = isExistential ? static_cast<const ExistentialFormula&>(f).f : static_cast<const UniversalFormula&>(f).f;
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                ostr << (isExistential ? "(exists (" : "(forall (");
+                for (const auto& var : vars)
+                {
+                    ostr << "(" << var->name << " " << var->rngSort->toSMTLIB() << ")";
+                }
+                ostr << ")\n";
+                pushText(")", indentation);
+                pushText("\n");
+                if (letsEnabled && !sharing->letTerms(f).empty())
+                {
+                    pushLets(f, *subformula, indentation + 3);
+                }
+                else
+                {
+                    pushFormula(*subformula, indentation + 3);
+                }
+                break;
+            }
+            case Formula::Type::Implication:
+            case Formula::Type::Equivalence:
+            {
+                bool isImplication = f.type() == Formula::Type::Implication;
+                const auto& f1 = isImplication ? static_cast<const ImplicationFormula&>(f).f1 : static_cast<const EquivalenceFormula&>(f).f1;
+                const auto& f2 = isImplication ? static_cast<const ImplicationFormula&>(f).f2 : static_cast<const EquivalenceFormula&>(f).f2;
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                ostr << (isImplication ? "(=>\n" : "(=\n");
+                pushText(")", indentation);
+                pushText("\n");
+                pushFormula(*f2, indentation + 3);
+                pushText("\n");
+                pushFormula(*f1, indentation + 3);
+                break;
+            }
+            case Formula::Type::True:
+            case Formula::Type::False:
+            {
+                writeLabel(f, indentation);
+                writeIndentation(indentation);
+                ostr << (f.type() == Formula::Type::True ? "true" : "false");
+                break;
+            }
+            default:
+            {
+                assert(false);
+                break;
+            }
+        }
+    }
+
+    void SMTLIBWriter::writeIndentation(unsigned indentation)
+    {
+        static const std::string spaces(64, ' ');
+        while (indentation > spaces.size())
+        {
+            ostr.write(spaces.data(), spaces.size());
+            indentation -= spaces.size();
+        }
+        ostr.write(spaces.data(), indentation);
+    }
+
+    void SMTLIBWriter::writeLabel(const Formula& f, unsigned indentation)
+    {
+        if (!f.label.empty())
+        {
+            writeIndentation(indentation);
+            ostr << ";" << f.label << "\n";
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef __SMTLIBWriter__
+#define __SMTLIBWriter__
+
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+#include "Term.hpp"
+#include "Formula.hpp"
+#include "TermSharing.hpp"
+
+namespace logic {
+
+    /*
+     * writes terms and formulas in SMTLIB syntax directly into an output stream.
+     * the trees are traversed iteratively using an explicit work stack, so no intermediate strings are built
+     * and arbitrarily deep formulas can be written in time linear in their size.
+     * the produced output is the same as the one of Term::toSMTLIB() and Formula::toSMTLIB(indentation).
+     * if a TermSharing is given, the shared terms are printed only once, using define-fun and let.
+     */
+    class SMTLIBWriter
+    {
+    public:
+        SMTLIBWriter(std::ostream& ostr) : ostr(ostr), sharing(nullptr), stack(), activeTerms(), letsEnabled(false) {}
+        SMTLIBWriter(std::ostream& ostr, const TermSharing& sharing) : ostr(ostr), sharing(&sharing), stack(), activeTerms(), letsEnabled(false) {}
+
+        void write(const Term& t);
+        void write(const Formula& f, unsigned indentation = 0);
+        // output a define-fun for each shared closed term. Must be called before the formulas are written.
+        void writeDefinitions();
+
+    private:
+        std::ostream& ostr;
+        const TermSharing* sharing;
+
+        // an item of the work stack: either a term, a formula (together with its indentation), a fixed piece of text,
+        // or one of the items needed for sharing terms.
+        struct Item
+        {
+            enum class Kind { Term, Formula, Text, Definition, LetOpen, Activate, LetClose };
+
+            Kind kind;
+            const void* node;
+            const char* text;
+            unsigned indentation;
+        };
+        std::vector<Item> stack;
+
+        // the shared terms which are currently defined, and therefore are printed using their name
+        std::unordered_set<const Term*> activeTerms;
+        bool letsEnabled;
+
+        void pushTerm(const Term& t) { stack.push_back({Item::Kind::Term, &t, nullptr, 0}); }
+        void pushFormula(const Formula& f, unsigned indentation) { stack.push_back({Item::Kind::Formula, &f, nullptr, indentation}); }
+        void pushText(const char* text, unsigned indentation = 0) { stack.push_back({Item::Kind::Text, nullptr, text, indentation}); }
+        // push the let-bindings of the quantified formula 'f', followed by 'subformula' and the closing parentheses
+        void pushLets(const Formula& f, const Formula& subformula, unsigned indentation);
+
+        // process the stack until it is empty
+        void run();
+        // write the term, or its name if it is a shared term which is currently defined
+        void process(const Term& t);
+        // write the top-level structure of the term, even if it is a shared term
+        void processDefinition(const Term& t);
+        void process(const Formula& f, unsigned indentation);
+        // push 'open', then the terms separated by spaces and finally 'close'
+        void pushTerms(const std::vector<std::shared_ptr<const Term>>& terms);
+
+        void writeIndentation(unsigned indentation);
+        void writeLabel(const Formula& f, unsigned indentation);
+    };
+}
+
+#endif
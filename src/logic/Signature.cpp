@@ -9,15 +9,20 @@
 #include <vector>
 #include <cassert>
 
+#include "NodeArena.hpp"
 #include "Options.hpp"
+#include "LogicContext.hpp"
+#include "Statistics.hpp"
 
 namespace logic {
+
+    static util::Statistics::Counter symbolsInterned("symbols interned");
     
 #pragma mark - Symbol
 
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Symbol>>& f){ostr << "not implemented"; return ostr;}
     
-    std::string Symbol::declareSymbolSMTLIB() const
+    std::string Symbol::computeSMTLIBDeclaration() const
     {
         if (!noDeclaration)
         {
@@ -29,12 +34,12 @@ namespace logic {
             }
             if (argSorts.size() == 0 && !(isLemmaPredicate && util::Configuration::instance().lemmaPredicates()))
             {
-                return "(declare-const " + toSMTLIB() + " " + rngSort->toSMTLIB() + ")\n";
+                return "(declare-const " + smtlibName + " " + rngSort->toSMTLIB() + ")\n";
             }
             else
             {
                 std::string res = (isLemmaPredicate && util::Configuration::instance().lemmaPredicates()) ? "(declare-lemma-predicate " : "(declare-fun ";
-                res += toSMTLIB() + " (";
+                res += smtlibName + " (";
                 for (int i=0; i < argSorts.size(); ++i)
                 {
                     res += argSorts[i]->toSMTLIB() + (i+1 == argSorts.size() ? "" : " ");
@@ -49,7 +54,7 @@ namespace logic {
         }
     }
     
-    std::string Symbol::toSMTLIB() const
+    std::string Symbol::computeSMTLIBName(const std::string& name)
     {
         // if non-negative integer constant
         if (std::all_of(name.begin(), name.end(), ::isdigit))
@@ -70,70 +75,96 @@ namespace logic {
     
 #pragma mark - Signature
     
-    std::unordered_map<std::string, std::shared_ptr<const Symbol>> Signature::_signature;
-    std::vector<std::shared_ptr<const Symbol>> Signature::_signatureOrderedByInsertion;
+    Signature::State& Signature::state()
+    {
+        return LogicContext::current().signature;
+    }
+
+    std::size_t Signature::VarSymbolKeyHash::operator ()(const VarSymbolKey& key) const
+    {
+        size_t result = std::hash<std::string>()(key.first);
+        result ^= std::hash<const Sort*>()(key.second) + 0x9e3779b9 + (result << 6) + (result >> 2);
+        return result;
+    }
 
-    bool Signature::isDeclared(std::string name)
+    bool Signature::isDeclared(const std::string& name)
     {
-        auto it = _signature.find(name);
-        return (it != _signature.end());
+        auto it = state().signature.find(name);
+        return (it != state().signature.end());
     }
     
-    std::shared_ptr<const Symbol> Signature::add(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration)
+    std::shared_ptr<const Symbol> Signature::add(const std::string& name, const std::vector<const Sort*>& argSorts, const Sort* rngSort, bool noDeclaration)
     {
         // there must be no symbol with name name already added
-        assert(_signature.count(name) == 0);
+        assert(state().signature.count(name) == 0);
         
-        auto pair = _signature.insert(std::make_pair(name,std::unique_ptr<Symbol>(new Symbol(name, argSorts, rngSort, false, noDeclaration))));
+        auto pair = state().signature.insert(std::make_pair(name, newNode<Symbol>(state().nextId++, name, argSorts, rngSort, false, noDeclaration)));
         assert(pair.second); // must succeed since we checked that no such symbols existed before the insertion
+        symbolsInterned.increment();
 
         auto symbol = pair.first->second;
-        _signatureOrderedByInsertion.push_back(symbol);
+        state().signatureOrderedByInsertion.push_back(symbol);
         return symbol;
     }
     
-    std::shared_ptr<const Symbol> Signature::fetch(std::string name)
+    std::shared_ptr<const Symbol> Signature::fetch(const std::string& name)
     {
-        auto it = _signature.find(name);
-        assert(it != _signature.end());
+        auto it = state().signature.find(name);
+        assert(it != state().signature.end());
         
         return it->second;
     }
+
+    std::shared_ptr<const Symbol> Signature::tryFetch(const std::string& name)
+    {
+        auto it = state().signature.find(name);
+        return it == state().signature.end() ? nullptr : it->second;
+    }
     
-    std::shared_ptr<const Symbol> Signature::fetchOrAdd(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration)
+    std::shared_ptr<const Symbol> Signature::fetchOrAdd(const std::string& name, const std::vector<const Sort*>& argSorts, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration)
     {
-        auto pair = _signature.insert(std::make_pair(name, std::shared_ptr<Symbol>(new Symbol(name, argSorts, rngSort, isLemmaPredicate, noDeclaration))));
-        auto symbol = pair.first->second;
-
-        if (pair.second)
+        auto it = state().signature.find(name);
+        if (it == state().signature.end())
         {
-            _signatureOrderedByInsertion.push_back(symbol);
+            auto symbol = newNode<Symbol>(state().nextId++, name, argSorts, rngSort, isLemmaPredicate, noDeclaration);
+            symbolsInterned.increment();
+            state().signature.insert(std::make_pair(name, symbol));
+            state().signatureOrderedByInsertion.push_back(symbol);
+            return symbol;
         }
+
         // if a symbol with the name already exist, make sure it has the same sorts and attributes
-        else
+        const auto& symbol = it->second;
+        if (argSorts.size() != symbol->argSorts.size())
         {
-            if (argSorts.size() != symbol->argSorts.size())
-            {
-                std::cout << "User error: symbol " << symbol->name << " requires " << symbol->argSorts.size() << " arguments, but " << argSorts.size() << " arguments where given" << std::endl;
-                assert(false);
-            }
-            for (int i=0; i < argSorts.size(); ++i)
-            {
-                assert(argSorts[i] == symbol->argSorts[i]);
-            }
-            assert(rngSort = symbol->rngSort);
-            assert(isLemmaPredicate == symbol->isLemmaPredicate);
-            assert(noDeclaration == symbol->noDeclaration);
+            std::cout << "User error: symbol " << symbol->name << " requires " << symbol->argSorts.size() << " arguments, but " << argSorts.size() << " arguments where given" << std::endl;
+            assert(false);
+        }
+        for (int i=0; i < argSorts.size(); ++i)
+        {
+            assert(argSorts[i] == symbol->argSorts[i]);
         }
+        assert(rngSort == symbol->rngSort);
+        assert(isLemmaPredicate == symbol->isLemmaPredicate);
+        assert(noDeclaration == symbol->noDeclaration);
         return symbol;
     }
     
-    std::shared_ptr<const Symbol> Signature::varSymbol(std::string name, const Sort* rngSort)
+    std::shared_ptr<const Symbol> Signature::varSymbol(const std::string& name, const Sort* rngSort)
     {
         // there must be no symbol with name name already added
-        assert(_signature.count(name) == 0);
-        
-        return std::shared_ptr<Symbol>(new Symbol(name, rngSort, false, true));
+        assert(state().signature.count(name) == 0);
+
+        auto key = std::make_pair(name, rngSort);
+        auto it = state().varSymbols.find(key);
+        if (it != state().varSymbols.end())
+        {
+            return it->second;
+        }
+        auto symbol = newNode<Symbol>(state().nextId++, name, rngSort, false, true);
+        symbolsInterned.increment();
+        state().varSymbols.insert(std::make_pair(std::move(key), symbol));
+        return symbol;
     }
 
 }
@@ -11,6 +11,7 @@
 #include <vector>
 #include <cassert>
 
+#include "NodeArena.hpp"
 #include "Sort.hpp"
 
 # pragma mark - Symbol
@@ -21,45 +22,63 @@ namespace logic {
         // we need each symbol to be either declared in the signature or to be a variable (which will be declared by the quantifier)
         // We use the Signature-class below as a manager-class for symbols of the first kind
         friend class Signature;
+        template<typename> friend class NodeAllocator;
         
     private:
-        Symbol(std::string name, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration) :
+        Symbol(unsigned id, std::string name, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration) :
+        id(id),
         name(name),
         argSorts(),
         rngSort(rngSort),
         isLemmaPredicate(isLemmaPredicate),
-        noDeclaration(noDeclaration)
+        noDeclaration(noDeclaration),
+        smtlibName(computeSMTLIBName(this->name)),
+        smtlibDeclaration(computeSMTLIBDeclaration())
         {
             assert(!name.empty());
             assert(!isLemmaPredicate || isPredicateSymbol());
         }
 
-        Symbol(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration) :
+        Symbol(unsigned id, std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool isLemmaPredicate, bool noDeclaration) :
+        id(id),
         name(name),
         argSorts(std::move(argSorts)),
         rngSort(rngSort),
         isLemmaPredicate(isLemmaPredicate),
-        noDeclaration(noDeclaration)
+        noDeclaration(noDeclaration),
+        smtlibName(computeSMTLIBName(this->name)),
+        smtlibDeclaration(computeSMTLIBDeclaration())
         {
             assert(!name.empty());
             assert(!isLemmaPredicate || isPredicateSymbol());
         }
      
     public:
+        // unique id of the symbol, assigned by Signature. Symbols are interned, so the id identifies the symbol.
+        const unsigned id;
         const std::string name;
         const std::vector<const Sort*> argSorts;
         const Sort* rngSort;
         const bool isLemmaPredicate; // lemma predicates will be annotated in the smtlib-output, so that Vampire can treat them differently
         const bool noDeclaration; // true iff the symbol needs no declaration in smtlib (i.e. true only for interpreted symbols and variables)
 
+    private:
+        // the smtlib-strings are computed once when the symbol is constructed, since they are needed for each reasoning task
+        const std::string smtlibName;
+        const std::string smtlibDeclaration;
+
+        static std::string computeSMTLIBName(const std::string& name);
+        std::string computeSMTLIBDeclaration() const;
+
+    public:
         bool isPredicateSymbol() const { return rngSort == Sorts::boolSort(); }
          
-        std::string toSMTLIB() const;
-        std::string declareSymbolSMTLIB() const;
+        const std::string& toSMTLIB() const { return smtlibName; }
+        const std::string& declareSymbolSMTLIB() const { return smtlibDeclaration; }
         std::string declareSymbolColorSMTLIB() const;
         
-        bool operator==(const Symbol &s) const {return name == s.name;}
-        bool operator!=(const Symbol &s) const {return !(name == s.name);}
+        bool operator==(const Symbol &s) const {return id == s.id;}
+        bool operator!=(const Symbol &s) const {return id != s.id;}
     };
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
@@ -76,7 +95,7 @@ namespace std
 
         result_type operator ()(argument_type const& s) const
         {
-            return std::hash<std::string>()(s.name);
+            return std::hash<unsigned>()(s.id);
         }
     };
 
@@ -87,7 +106,7 @@ namespace std
 
         result_type operator ()(argument_type const& s) const
         {
-            return std::hash<std::string>()(s.name);
+            return std::hash<unsigned>()(s.id);
         }
     };
 }
@@ -96,28 +115,50 @@ namespace std
 
 namespace logic {
     
-    // We use Signature as a manager-class for Symbol-instances
+    // We use Signature as a manager-class for Symbol-instances.
+    // Symbols are interned: each symbol is constructed only once and gets a dense id. Fetching an existing symbol doesn't allocate.
     class Signature
     {
     public:
-        static bool isDeclared(std::string name);
+        static bool isDeclared(const std::string& name);
 
         // construct new symbols
-        static std::shared_ptr<const Symbol> add(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration=false);
-        static std::shared_ptr<const Symbol> fetch(std::string name);
-        static std::shared_ptr<const Symbol> fetchOrAdd(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool isLemmaPredicate=false, bool noDeclaration=false);
+        static std::shared_ptr<const Symbol> add(const std::string& name, const std::vector<const Sort*>& argSorts, const Sort* rngSort, bool noDeclaration=false);
+        static std::shared_ptr<const Symbol> fetch(const std::string& name);
+        static std::shared_ptr<const Symbol> fetchOrAdd(const std::string& name, const std::vector<const Sort*>& argSorts, const Sort* rngSort, bool isLemmaPredicate=false, bool noDeclaration=false);
+        // return the symbol with the given name, or nullptr if there is no such symbol
+        static std::shared_ptr<const Symbol> tryFetch(const std::string& name);
 
         // check that variable doesn't use name which already occurs in Signature
-        // return Symbol without adding it to Signature
-        static std::shared_ptr<const Symbol> varSymbol(std::string name, const Sort* rngSort);
+        // return Symbol without adding it to Signature (variable symbols with the same name and sort are shared)
+        static std::shared_ptr<const Symbol> varSymbol(const std::string& name, const Sort* rngSort);
 
-        static const std::vector<std::shared_ptr<const Symbol>>& signatureOrderedByInsertion(){return _signatureOrderedByInsertion;}
+        static const std::vector<std::shared_ptr<const Symbol>>& signatureOrderedByInsertion(){return state().signatureOrderedByInsertion;}
         
     private:
-        // _signature collects all symbols used so far.
-        static std::unordered_map<std::string, std::shared_ptr<const Symbol>> _signature;
-        // symbols of signature, in the order of insertion.
-        static std::vector<std::shared_ptr<const Symbol>> _signatureOrderedByInsertion;
+        // symbols of variables, identified by name and sort
+        typedef std::pair<std::string, const Sort*> VarSymbolKey;
+        class VarSymbolKeyHash {
+        public:
+            std::size_t operator ()(const VarSymbolKey& key) const;
+        };
+
+    public:
+        // the symbols constructed in a LogicContext
+        struct State
+        {
+            // signature collects all symbols used so far.
+            std::unordered_map<std::string, std::shared_ptr<const Symbol>> signature;
+            // symbols of signature, in the order of insertion.
+            std::vector<std::shared_ptr<const Symbol>> signatureOrderedByInsertion;
+            std::unordered_map<VarSymbolKey, std::shared_ptr<const Symbol>, VarSymbolKeyHash> varSymbols;
+            // the id which will be assigned to the next constructed symbol
+            unsigned nextId = 0;
+        };
+
+    private:
+        // the state of the current LogicContext
+        static State& state();
     };
 }
 #endif
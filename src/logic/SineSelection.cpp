@@ -0,0 +1,202 @@
+#include "SineSelection.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <unordered_set>
+
+namespace logic {
+
+    SineSelection::SineSelection(const std::vector<const std::vector<const Symbol*>*>& axiomSymbols, const std::vector<const Symbol*>& conjectureSymbols, unsigned maxDepth) :
+        selected(axiomSymbols.size(), false),
+        relevant()
+    {
+        // count for each symbol the number of axioms it occurs in
+        std::vector<unsigned> occurrences;
+        for (const auto& symbols : axiomSymbols)
+        {
+            for (const auto& symbol : *symbols)
+            {
+                if (symbol->id >= occurrences.size())
+                {
+                    occurrences.resize(symbol->id + 1, 0);
+                }
+                occurrences[symbol->id]++;
+            }
+        }
+
+        // the axioms triggered by each symbol
+        std::vector<std::vector<unsigned>> triggered(occurrences.size());
+        for (unsigned i = 0; i < axiomSymbols.size(); ++i)
+        {
+            const auto& symbols = *axiomSymbols[i];
+            if (symbols.empty())
+            {
+                selected[i] = true;
+                continue;
+            }
+            // lemma predicates only abbreviate parts of a single lemma, so they trigger each axiom containing them
+            // (in particular their definition), and are ignored when computing the least common symbols.
+            unsigned minOccurrences = UINT_MAX;
+            for (const auto& symbol : symbols)
+            {
+                if (!symbol->isLemmaPredicate)
+                {
+                    minOccurrences = std::min(minOccurrences, occurrences[symbol->id]);
+                }
+            }
+            for (const auto& symbol : symbols)
+            {
+                if (symbol->isLemmaPredicate || occurrences[symbol->id] == minOccurrences)
+                {
+                    triggered[symbol->id].push_back(i);
+                }
+            }
+        }
+
+        // breadth-first search starting from the symbols of the conjecture
+        std::vector<const Symbol*> current;
+        auto addRelevant = [&](const Symbol* symbol)
+        {
+            if (symbol->id >= relevant.size())
+            {
+                relevant.resize(symbol->id + 1, false);
+            }
+            if (!relevant[symbol->id])
+            {
+                relevant[symbol->id] = true;
+                current.push_back(symbol);
+            }
+        };
+        for (const auto& symbol : conjectureSymbols)
+        {
+            addRelevant(symbol);
+        }
+        for (unsigned depth = 0; !current.empty() && (maxDepth == 0 || depth < maxDepth); ++depth)
+        {
+            auto symbols = std::move(current);
+            current.clear();
+            for (const auto& symbol : symbols)
+            {
+                if (symbol->id >= triggered.size())
+                {
+                    continue;
+                }
+                for (const auto& axiom : triggered[symbol->id])
+                {
+                    if (!selected[axiom])
+                    {
+                        selected[axiom] = true;
+                        for (const auto& s : *axiomSymbols[axiom])
+                        {
+                            addRelevant(s);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    namespace
+    {
+        void collectSymbols(const Term& t, std::unordered_set<const Term*>& visited, std::unordered_set<const Symbol*>& symbols)
+        {
+            if (t.type() != Term::Type::FuncTerm || !visited.insert(&t).second)
+            {
+                return;
+            }
+            if (!t.symbol->noDeclaration)
+            {
+                symbols.insert(t.symbol.get());
+            }
+            for (const auto& subterm : static_cast<const FuncTerm&>(t).subterms)
+            {
+                collectSymbols(*subterm, visited, symbols);
+            }
+        }
+
+        void collectSymbols(const Formula& f, std::unordered_set<const Term*>& visited, std::unordered_set<const Symbol*>& symbols)
+        {
+            switch (f.type())
+            {
+                case Formula::Type::Predicate:
+                {
+                    auto& castedFormula = static_cast<const PredicateFormula&>(f);
+                    if (!castedFormula.symbol->noDeclaration)
+                    {
+                        symbols.insert(castedFormula.symbol.get());
+                    }
+                    for (const auto& subterm : castedFormula.subterms)
+                    {
+                        collectSymbols(*subterm, visited, symbols);
+                    }
+                    break;
+                }
+                case Formula::Type::Equality:
+                {
+                    auto& castedFormula = static_cast<const EqualityFormula&>(f);
+                    collectSymbols(*castedFormula.left, visited, symbols);
+                    collectSymbols(*castedFormula.right, visited, symbols);
+                    break;
+                }
+                case Formula::Type::Conjunction:
+                {
+                    for (const auto& conj : static_cast<const ConjunctionFormula&>(f).conj)
+                    {
+                        collectSymbols(*conj, visited, symbols);
+                    }
+                    break;
+                }
+                case Formula::Type::Disjunction:
+                {
+                    for (const auto& disj : static_cast<const DisjunctionFormula&>(f).disj)
+                    {
+                        collectSymbols(*disj, visited, symbols);
+                    }
+                    break;
+                }
+                case Formula::Type::Negation:
+                {
+                    collectSymbols(*static_cast<const NegationFormula&>(f).f, visited, symbols);
+                    break;
+                }
+                case Formula::Type::Existential:
+                {
+                    collectSymbols(*static_cast<const ExistentialFormula&>(f).f, visited, symbols);
+                    break;
+                }
+                case Formula::Type::Universal:
+                {
+                    collectSymbols(*static_cast<const UniversalFormula&>(f).f, visited, symbols);
+                    break;
+                }
+                case Formula::Type::Implication:
+                {
+                    auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                    collectSymbols(*castedFormula.f1, visited, symbols);
+                    collectSymbols(*castedFormula.f2, visited, symbols);
+                    break;
+                }
+                case Formula::Type::Equivalence:
+                {
+                    auto& castedFormula = static_cast<const EquivalenceFormula&>(f);
+                    collectSymbols(*castedFormula.f1, visited, symbols);
+                    collectSymbols(*castedFormula.f2, visited, symbols);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    std::vector<const Symbol*> SineSelection::symbols(const Formula& f)
+    {
+        std::unordered_set<const Term*> visited;
+        std::unordered_set<const Symbol*> symbols;
+        collectSymbols(f, visited, symbols);
+
+        std::vector<const Symbol*> result(symbols.begin(), symbols.end());
+        std::sort(result.begin(), result.end(), [](const Symbol* s1, const Symbol* s2) { return s1->id < s2->id; });
+        return result;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef __SineSelection__
+#define __SineSelection__
+
+#include <vector>
+
+#include "Formula.hpp"
+#include "Signature.hpp"
+
+namespace logic {
+
+    /*
+     * SInE-style relevance filter for the axioms of a reasoning task:
+     * an axiom is triggered by a symbol, if the symbol occurs in the axiom and no other symbol of the axiom occurs in fewer
+     * axioms of the task (i.e. we use tolerance 1). Starting with the symbols of the conjecture, the axioms triggered
+     * by relevant symbols are selected, and the symbols of the selected axioms become relevant in the next round.
+     * Only declared symbols are considered, so axioms which contain no declared symbol are always selected.
+     * Lemma predicates are treated specially, see the constructor.
+     */
+    class SineSelection
+    {
+    public:
+        // axiomSymbols[i] are the symbols of the i-th axiom. maxDepth bounds the number of rounds (0 means no bound).
+        SineSelection(const std::vector<const std::vector<const Symbol*>*>& axiomSymbols, const std::vector<const Symbol*>& conjectureSymbols, unsigned maxDepth);
+
+        bool isSelected(unsigned axiom) const { return selected[axiom]; }
+        // true iff the symbol occurs in the conjecture or in a selected axiom
+        bool isRelevant(const Symbol& symbol) const { return symbol.id < relevant.size() && relevant[symbol.id]; }
+
+        // the declared symbols occurring in 'f', ordered by id
+        static std::vector<const Symbol*> symbols(const Formula& f);
+
+    private:
+        std::vector<bool> selected;
+        // indexed by symbol id
+        std::vector<bool> relevant;
+    };
+}
+
+#endif
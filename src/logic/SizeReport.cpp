@@ -0,0 +1,271 @@
+#include "SizeReport.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include "Output.hpp"
+
+namespace logic {
+
+    namespace
+    {
+        class ItemSize
+        {
+        public:
+            ItemSize() : items(0), nodes(0), quantifierDepth(0), bytes(0), tasks(0), taskBytes(0) {}
+
+            std::uint64_t items;
+            std::uint64_t nodes;
+            // for the totals, the maximal quantifier depth of the items
+            unsigned quantifierDepth;
+            std::uint64_t bytes;
+            std::uint64_t tasks;
+            std::uint64_t taskBytes;
+
+            void add(const ItemSize& other)
+            {
+                items += other.items;
+                nodes += other.nodes;
+                quantifierDepth = std::max(quantifierDepth, other.quantifierDepth);
+                bytes += other.bytes;
+                tasks += other.tasks;
+                taskBytes += other.taskBytes;
+            }
+        };
+
+        // the number of nodes of the term, counted as tree. Terms are shared, so the sizes are cached.
+        std::uint64_t numberOfNodes(const Term& t, std::unordered_map<const Term*, std::uint64_t>& termSizes)
+        {
+            auto it = termSizes.find(&t);
+            if (it != termSizes.end())
+            {
+                return it->second;
+            }
+            std::uint64_t size = 1;
+            if (t.type() == Term::Type::FuncTerm)
+            {
+                for (const auto& subterm : static_cast<const FuncTerm&>(t).subterms)
+                {
+                    size += numberOfNodes(*subterm, termSizes);
+                }
+            }
+            termSizes[&t] = size;
+            return size;
+        }
+
+        // compute the number of nodes and the quantifier depth of the formula
+        void measure(const Formula& f, unsigned depth, std::unordered_map<const Term*, std::uint64_t>& termSizes, ItemSize& size)
+        {
+            size.nodes++;
+            switch (f.type())
+            {
+                case Formula::Type::Predicate:
+                {
+                    for (const auto& subterm : static_cast<const PredicateFormula&>(f).subterms)
+                    {
+                        size.nodes += numberOfNodes(*subterm, termSizes);
+                    }
+                    break;
+                }
+                case Formula::Type::Equality:
+                {
+                    auto& castedFormula = static_cast<const EqualityFormula&>(f);
+                    size.nodes += numberOfNodes(*castedFormula.left, termSizes);
+                    size.nodes += numberOfNodes(*castedFormula.right, termSizes);
+                    break;
+                }
+                case Formula::Type::Conjunction:
+                {
+                    for (const auto& conj : static_cast<const ConjunctionFormula&>(f).conj)
+                    {
+                        measure(*conj, depth, termSizes, size);
+                    }
+                    break;
+                }
+                case Formula::Type::Disjunction:
+                {
+                    for (const auto& disj : static_cast<const DisjunctionFormula&>(f).disj)
+                    {
+                        measure(*disj, depth, termSizes, size);
+                    }
+                    break;
+                }
+                case Formula::Type::Negation:
+                {
+                    measure(*static_cast<const NegationFormula&>(f).f, depth, termSizes, size);
+                    break;
+                }
+                case Formula::Type::Existential:
+                {
+                    size.quantifierDepth = std::max(size.quantifierDepth, depth + 1);
+                    measure(*static_cast<const ExistentialFormula&>(f).f, depth + 1, termSizes, size);
+                    break;
+                }
+                case Formula::Type::Universal:
+                {
+                    size.quantifierDepth = std::max(size.quantifierDepth, depth + 1);
+                    measure(*static_cast<const UniversalFormula&>(f).f, depth + 1, termSizes, size);
+                    break;
+                }
+                case Formula::Type::Implication:
+                {
+                    auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                    measure(*castedFormula.f1, depth, termSizes, size);
+                    measure(*castedFormula.f2, depth, termSizes, size);
+                    break;
+                }
+                case Formula::Type::Equivalence:
+                {
+                    auto& castedFormula = static_cast<const EquivalenceFormula&>(f);
+                    measure(*castedFormula.f1, depth, termSizes, size);
+                    measure(*castedFormula.f2, depth, termSizes, size);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        std::string typeName(ProblemItem::Type type)
+        {
+            switch (type)
+            {
+                case ProblemItem::Type::Program: return "program";
+                case ProblemItem::Type::Axiom: return "axiom";
+                case ProblemItem::Type::Definition: return "definition";
+                case ProblemItem::Type::Lemma: return "lemma";
+                case ProblemItem::Type::Conjecture: return "conjecture";
+            }
+            return "";
+        }
+
+        void outputSize(std::ostream& ostr, const ItemSize& size)
+        {
+            ostr << "\"nodes\": " << size.nodes << ", \"quantifierDepth\": " << size.quantifierDepth << ", \"bytes\": " << size.bytes << ", \"tasks\": " << size.tasks << ", \"taskBytes\": " << size.taskBytes;
+        }
+
+        void outputOrigin(std::ostream& ostr, const ItemOrigin& origin)
+        {
+            ostr << "\"generator\": \"" << util::escapeJSON(origin.generator) << "\", \"kind\": \"" << util::escapeJSON(origin.kind) << "\", \"location\": \"" << util::escapeJSON(origin.location) << "\", \"variable\": \"" << util::escapeJSON(origin.variable) << "\"";
+        }
+    }
+
+    void outputSizeReport(const std::vector<ReasoningTask>& tasks, std::ostream& ostr)
+    {
+        // the measured items: the axioms of the problem (by index), followed by the conjecture of each task
+        std::vector<const ProblemItem*> items;
+        std::vector<ItemSize> sizes;
+        std::unordered_map<const Term*, std::uint64_t> termSizes;
+        auto addItem = [&](const ProblemItem& item, std::uint64_t bytes)
+        {
+            ItemSize size;
+            size.items = 1;
+            size.bytes = bytes;
+            measure(*item.formula, 0, termSizes, size);
+            items.push_back(&item);
+            sizes.push_back(size);
+        };
+
+        if (!tasks.empty())
+        {
+            const auto& sequence = *tasks.front().items;
+            for (unsigned i = 0; i < sequence.asAxioms.size(); ++i)
+            {
+                if (sequence.asAxioms[i] != nullptr)
+                {
+                    addItem(*sequence.asAxioms[i], sequence.renderedAxiom(i).size());
+                }
+                else
+                {
+                    // keep the indices of the axioms, conjectures are measured as part of their task
+                    items.push_back(nullptr);
+                    sizes.push_back(ItemSize());
+                }
+            }
+            for (const auto& task : tasks)
+            {
+                addItem(*task.conjecture, task.renderedConjecture().size());
+                sizes.back().tasks = 1;
+                sizes.back().taskBytes = sizes.back().bytes;
+
+                for (const auto& index : task.selectedAxiomIndices())
+                {
+                    sizes[index].tasks++;
+                    sizes[index].taskBytes += sizes[index].bytes;
+                }
+            }
+        }
+
+        // the totals for each generator and for each origin
+        ItemSize total;
+        std::map<std::string, ItemSize> generators;
+        std::map<std::tuple<std::string, std::string, std::string, std::string>, ItemSize> origins;
+        for (unsigned i = 0; i < items.size(); ++i)
+        {
+            if (items[i] == nullptr)
+            {
+                continue;
+            }
+            const auto& origin = items[i]->origin;
+            total.add(sizes[i]);
+            generators[origin.generator].add(sizes[i]);
+            origins[std::make_tuple(origin.generator, origin.kind, origin.location, origin.variable)].add(sizes[i]);
+        }
+
+        // the largest contributions come first
+        std::vector<std::pair<ItemOrigin, ItemSize>> sortedOrigins;
+        for (const auto& [key, size] : origins)
+        {
+            ItemOrigin origin;
+            std::tie(origin.generator, origin.kind, origin.location, origin.variable) = key;
+            sortedOrigins.emplace_back(origin, size);
+        }
+        std::stable_sort(sortedOrigins.begin(), sortedOrigins.end(), [](const std::pair<ItemOrigin, ItemSize>& p1, const std::pair<ItemOrigin, ItemSize>& p2)
+        {
+            return p1.second.taskBytes > p2.second.taskBytes;
+        });
+
+        ostr << "{\n  \"tasks\": " << tasks.size() << ",\n  \"total\": {\"items\": " << total.items << ", ";
+        outputSize(ostr, total);
+        ostr << "},\n  \"generators\": [";
+        bool first = true;
+        for (const auto& [generator, size] : generators)
+        {
+            ostr << (first ? "\n" : ",\n") << "    {\"generator\": \"" << util::escapeJSON(generator) << "\", \"items\": " << size.items << ", ";
+            outputSize(ostr, size);
+            ostr << "}";
+            first = false;
+        }
+        ostr << "\n  ],\n  \"origins\": [";
+        first = true;
+        for (const auto& [origin, size] : sortedOrigins)
+        {
+            ostr << (first ? "\n" : ",\n") << "    {";
+            outputOrigin(ostr, origin);
+            ostr << ", \"items\": " << size.items << ", ";
+            outputSize(ostr, size);
+            ostr << "}";
+            first = false;
+        }
+        ostr << "\n  ],\n  \"items\": [";
+        first = true;
+        for (unsigned i = 0; i < items.size(); ++i)
+        {
+            if (items[i] == nullptr)
+            {
+                continue;
+            }
+            ostr << (first ? "\n" : ",\n") << "    {\"name\": \"" << util::escapeJSON(items[i]->name) << "\", \"type\": \"" << typeName(items[i]->type) << "\", ";
+            outputOrigin(ostr, items[i]->origin);
+            ostr << ", ";
+            outputSize(ostr, sizes[i]);
+            ostr << "}";
+            first = false;
+        }
+        ostr << "\n  ]\n}\n";
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef __SizeReport__
+#define __SizeReport__
+
+#include <iostream>
+#include <vector>
+
+#include "Problem.hpp"
+
+namespace logic {
+
+    /*
+     * attributes the size of the reasoning tasks to the origins of their items (see ItemOrigin), so that the generators
+     * which inflate the tasks can be found. For each axiom and conjecture, the length of its SMTLIB-text, its number of
+     * nodes (formulas and terms, counted as tree) and its quantifier depth are computed, and the length of the text is
+     * added once for each task containing the item (taskBytes). Declarations and shared terms are not attributed.
+     * the report lists the totals for each generator, for each origin, and the values of each item as JSON object.
+     * all tasks must be generated by the same problem.
+     */
+    void outputSizeReport(const std::vector<ReasoningTask>& tasks, std::ostream& ostr);
+}
+
+#endif
@@ -7,35 +7,20 @@
 #include <utility>
 
 #include "Options.hpp"
+#include "LogicContext.hpp"
 
 namespace logic {
     
 #pragma mark - Sort
     
-    std::string Sort::toSMTLIB() const
+    std::string Sort::computeSMTLIBDeclaration() const
     {
-        if (name == "Int")
-        {
-            return "Int";
-        }
-        else if (name == "Bool")
-        {
-            return "Bool";
-        }
-        else
-        {
-            return name;
-        }
-    }
-    
-    std::string declareSortSMTLIB(const Sort& s)
-    {
-        if (s.toSMTLIB() == "Int" || s.toSMTLIB() == "Bool")
+        if (name == "Int" || name == "Bool")
         {
             // SMTLIB already knows Int and Bool.
             return "";
         }
-        else if (s.toSMTLIB() == "Nat")
+        else if (name == "Nat")
         {
             if (util::Configuration::instance().nativeNat())
             {
@@ -48,13 +33,18 @@ namespace logic {
         }
         else
         {
-            return "(declare-sort " + s.toSMTLIB() + " 0)\n";
+            return "(declare-sort " + smtlibName + " 0)\n";
         }
     }
+
+    const std::string& declareSortSMTLIB(const Sort& s)
+    {
+        return s.declareSMTLIB();
+    }
     
     bool Sort::operator==(Sort& o)
     {
-        return name == o.name;
+        return id == o.id;
     }
     
     std::ostream& operator<<(std::ostream& ostr, const Sort& s) {
@@ -64,16 +54,23 @@ namespace logic {
     
 #pragma mark - Sorts
 
-    std::map<std::string, std::unique_ptr<Sort>> Sorts::_sorts;
+    Sorts::State& Sorts::state()
+    {
+        return LogicContext::current().sorts;
+    }
 
-    Sort* Sorts::fetchOrDeclare(std::string name)
+    Sort* Sorts::fetchOrDeclare(const std::string& name)
     {
-        auto it = _sorts.find(name);
+        auto& sorts = state().sorts;
+        auto it = sorts.find(name);
         
-        if (it == _sorts.end())
+        if (it == sorts.end())
         {
-            auto ret = _sorts.insert(std::make_pair(name, std::unique_ptr<Sort>(new Sort(name))));
-            return ret.first->second.get();
+            auto& sortsById = state().sortsById;
+            auto ret = sorts.insert(std::make_pair(name, std::unique_ptr<Sort>(new Sort(sortsById.size(), name))));
+            auto sort = ret.first->second.get();
+            sortsById.push_back(sort);
+            return sort;
         }
         else
         {
@@ -82,4 +79,3 @@ namespace logic {
     }
     
 }
-
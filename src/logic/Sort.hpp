@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace logic {
     
@@ -18,18 +19,28 @@ namespace logic {
         
     private:
         // constructor is private to prevent accidental usage.
-        Sort(std::string name) : name(name){};
+        Sort(unsigned id, std::string name) : id(id), name(name), smtlibName(name), smtlibDeclaration(computeSMTLIBDeclaration()) {};
         
     public:
+        // unique id of the sort, assigned by Sorts. Ids are dense and start at 0.
+        const unsigned id;
         const std::string name;
         
         bool operator==(Sort& o);
         
-        std::string toSMTLIB() const;
+        const std::string& toSMTLIB() const { return smtlibName; }
+        const std::string& declareSMTLIB() const { return smtlibDeclaration; }
+
+    private:
+        // the smtlib-strings are computed once when the sort is constructed
+        const std::string smtlibName;
+        const std::string smtlibDeclaration;
+
+        std::string computeSMTLIBDeclaration() const;
     };
     std::ostream& operator<<(std::ostream& ostr, const Sort& s);
     
-    std::string declareSortSMTLIB(const Sort& s);
+    const std::string& declareSortSMTLIB(const Sort& s);
 
 
 #pragma mark - Sorts
@@ -39,19 +50,42 @@ namespace logic {
     class Sorts
     {
     public:
-        // construct various sorts
-        static Sort* boolSort() { return fetchOrDeclare("Bool"); }
-        static Sort* intSort() { return fetchOrDeclare("Int"); }
-        static Sort* natSort() { return fetchOrDeclare("Nat"); }
-        static Sort* timeSort() { return fetchOrDeclare("Time"); }
-        static Sort* traceSort() { return fetchOrDeclare("Trace"); }
+        // construct various sorts.
+        // the built-in sorts are declared on first use (so that only used sorts occur in the output) and are afterwards accessed in constant time.
+        static Sort* boolSort() { return builtinSort(Builtin::Bool, "Bool"); }
+        static Sort* intSort() { return builtinSort(Builtin::Int, "Int"); }
+        static Sort* natSort() { return builtinSort(Builtin::Nat, "Nat"); }
+        static Sort* timeSort() { return builtinSort(Builtin::Time, "Time"); }
+        static Sort* traceSort() { return builtinSort(Builtin::Trace, "Trace"); }
+
+        // construct arbitrary (e.g. user-declared) sorts
+        static Sort* fetchOrDeclare(const std::string& name);
+        static Sort* sortWithId(unsigned id) { return state().sortsById[id]; }
 
         // returns map containing all previously constructed sorts as pairs (nameOfSort, Sort)
-        static const std::map<std::string, std::unique_ptr<Sort>>& nameToSort(){return _sorts;};
+        static const std::map<std::string, std::unique_ptr<Sort>>& nameToSort(){return state().sorts;};
         
     private:
-        static Sort* fetchOrDeclare(std::string name);
-        static std::map<std::string, std::unique_ptr<Sort>> _sorts;
+        enum Builtin { Bool, Int, Nat, Time, Trace, NumberOfBuiltins };
+
+    public:
+        // the sorts constructed in a LogicContext
+        struct State
+        {
+            std::map<std::string, std::unique_ptr<Sort>> sorts;
+            std::vector<Sort*> sortsById;
+            Sort* builtinSorts[NumberOfBuiltins] = {};
+        };
+
+    private:
+        // the state of the current LogicContext
+        static State& state();
+
+        static Sort* builtinSort(Builtin builtin, const char* name)
+        {
+            auto& sort = state().builtinSorts[builtin];
+            return sort != nullptr ? sort : (sort = fetchOrDeclare(name));
+        }
     };
 
 
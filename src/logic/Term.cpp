@@ -2,79 +2,53 @@
 
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "NodeArena.hpp"
+#include "SMTLIBWriter.hpp"
+#include "LogicContext.hpp"
+#include "Statistics.hpp"
+
 namespace logic {
 
+    static util::Statistics::Counter termsCreated("terms created");
+
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Term>>& t){ostr << "not implemented"; return ostr;}
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::LVariable>>& v){ostr << "not implemented"; return ostr;}
 
-    unsigned LVariable::freshId = 0;
-
     bool operator==(const Term& t1, const Term& t2)
     {
-        if (t1.type() != t2.type())
-        {
-            return false;
-        }
-        if (t1.type() == Term::Type::Variable)
-        {
-            return *t1.symbol == *t2.symbol;
-        }
-        else
-        {
-            assert(t1.type() == Term::Type::FuncTerm);
-            auto f1 = static_cast<const FuncTerm&>(t1);
-            auto f2 = static_cast<const FuncTerm&>(t2);
-            if (*f1.symbol != *f2.symbol || f1.subterms.size() != f2.subterms.size())
-            {
-                return false;
-            }
-            for (unsigned i = 0; i < f1.subterms.size(); i++)
-            {
-                if (*f1.subterms[i] != *f2.subterms[i])
-                {
-                    return false;
-                }
-            }
-            return true;
-        }
+        // terms are hash-consed, so structural equality coincides with identity
+        return &t1 == &t2;
     }
     bool operator!=(const Term& t1, const Term& t2)
     {
         return !(t1 == t2);
     }
 
-    std::string LVariable::toSMTLIB() const
+    std::string Term::toSMTLIB() const
     {
-        return symbol->name;
+        std::stringstream ss;
+        SMTLIBWriter(ss).write(*this);
+        return ss.str();
     }
-    
-    std::string LVariable::prettyString() const
+
+    std::ostream& operator<<(std::ostream& ostr, const Term& e)
     {
-        return symbol->name;
+        SMTLIBWriter(ostr).write(e);
+        return ostr;
     }
 
-    std::string FuncTerm::toSMTLIB() const
+    std::string LVariable::prettyString() const
     {
-        if (subterms.size() == 0)
-        {
-            return symbol->toSMTLIB();
-        }
-        else
-        {
-            std::string str = "(" + symbol->toSMTLIB() + " ";
-            for (unsigned i = 0; i < subterms.size(); i++)
-            {
-                str += subterms[i]->toSMTLIB();
-                str += (i == subterms.size() - 1) ? ")" : " ";
-            }
-            return str;
-        }
+        return symbol->name;
     }
-    
+
     std::string FuncTerm::prettyString() const
     {
         if (subterms.size() == 0)
@@ -94,26 +68,73 @@ namespace logic {
 
 
 # pragma mark - Terms
-    
-    std::shared_ptr<const LVariable> Terms::var(std::shared_ptr<const Symbol> symbol)
+
+    Terms::State& Terms::state()
+    {
+        return LogicContext::current().terms;
+    }
+
+    std::shared_ptr<const LVariable> Terms::var(const std::shared_ptr<const Symbol>& symbol)
     {
-        return std::shared_ptr<const LVariable>(new LVariable(symbol));
+        auto& vars = state().vars;
+        auto it = vars.find(symbol->id);
+        if (it != vars.end())
+        {
+            return it->second;
+        }
+        // structural hash: start from symbol of term, then integrate type into the hash
+        size_t hash = std::hash<const Symbol>()(*symbol);
+        hash ^= std::hash<Term::Type>()(Term::Type::Variable) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+        auto var = newNode<LVariable>(symbol, state().nextId++, hash);
+        termsCreated.increment();
+        vars.insert(std::make_pair(symbol->id, var));
+        return var;
     }
     
-    std::shared_ptr<const FuncTerm> Terms::func(std::string name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration)
+    std::shared_ptr<const FuncTerm> Terms::func(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration)
     {
-        std::vector<const Sort*> subtermSorts;
-        for (const auto& subterm : subterms)
+        // usually the symbol already exists, in which case there is no need to collect the sorts of the subterms
+        // (the sorts of the subterms are checked when the term is constructed)
+        auto symbol = Signature::tryFetch(name);
+        if (symbol == nullptr || symbol->argSorts.size() != subterms.size())
         {
-            subtermSorts.push_back(subterm->symbol->rngSort);
+            std::vector<const Sort*> subtermSorts;
+            for (const auto& subterm : subterms)
+            {
+                subtermSorts.push_back(subterm->symbol->rngSort);
+            }
+            symbol = Signature::fetchOrAdd(name, subtermSorts, sort, false, noDeclaration);
         }
-        auto symbol = Signature::fetchOrAdd(name, subtermSorts, sort, false, noDeclaration);
-        return std::shared_ptr<const FuncTerm>(new FuncTerm(symbol, subterms));
+        assert(symbol->rngSort == sort);
+        assert(!symbol->isLemmaPredicate);
+        assert(symbol->noDeclaration == noDeclaration);
+        return func(symbol, std::move(subterms));
     }
     
-    std::shared_ptr<const FuncTerm> Terms::func(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms)
+    std::shared_ptr<const FuncTerm> Terms::func(const std::shared_ptr<const Symbol>& symbol, std::vector<std::shared_ptr<const Term>> subterms)
     {
-        return std::shared_ptr<const FuncTerm>(new FuncTerm(symbol, subterms));
+        // structural hash: start from symbol of term, then integrate type and the (cached) hash of each subterm into the hash
+        FuncTermKey key;
+        key.hash = std::hash<const Symbol>()(*symbol);
+        key.hash ^= std::hash<Term::Type>()(Term::Type::FuncTerm) + 0x9e3779b9 + (key.hash << 6) + (key.hash >> 2);
+        key.symbol = symbol.get();
+        key.subterms.reserve(subterms.size());
+        for (const auto& subterm : subterms)
+        {
+            key.hash ^= subterm->hash + 0x9e3779b9 + (key.hash << 6) + (key.hash >> 2);
+            key.subterms.push_back(subterm.get());
+        }
+
+        auto& funcTerms = state().funcTerms;
+        auto it = funcTerms.find(key);
+        if (it != funcTerms.end())
+        {
+            return it->second;
+        }
+        auto term = newNode<FuncTerm>(symbol, std::move(subterms), state().nextId++, key.hash);
+        termsCreated.increment();
+        funcTerms.insert(std::make_pair(std::move(key), term));
+        return term;
     }
 }
-
@@ -1,13 +1,16 @@
 #ifndef __Term__
 #define __Term__
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
 
+#include "NodeArena.hpp"
 #include "Signature.hpp"
 #include "Sort.hpp"
 
@@ -16,10 +19,16 @@ namespace logic {
     class Term
     {
     public:
-        Term(std::shared_ptr<const Symbol> symbol) : symbol(symbol) {}
+        Term(std::shared_ptr<const Symbol> symbol, unsigned id, std::size_t hash) : symbol(symbol), id(id), hash(hash) {}
         virtual ~Term() {}
 
         std::shared_ptr<const Symbol> symbol;
+
+        // unique id of the term, assigned by the term bank when the term is constructed.
+        // ids are dense and increasing, so each term has a larger id than all of its subterms.
+        const unsigned id;
+        // structural hash of the term, computed once when the term is constructed.
+        const std::size_t hash;
         
         enum class Type
         {
@@ -28,7 +37,8 @@ namespace logic {
         };
         virtual Type type() const = 0;
 
-        virtual std::string toSMTLIB() const = 0;
+        // note: for writing large terms to a stream, use SMTLIBWriter directly
+        std::string toSMTLIB() const;
         virtual std::string prettyString() const = 0;
     };
 
@@ -38,23 +48,20 @@ namespace logic {
     class LVariable : public Term
     {
         friend class Terms;
+        template<typename> friend class NodeAllocator;
         
-        LVariable(std::shared_ptr<const Symbol> symbol) : Term(symbol), id(freshId++){}
+        LVariable(std::shared_ptr<const Symbol> symbol, unsigned id, std::size_t hash) : Term(symbol, id, hash) {}
 
     public:
-        const unsigned id;
-
         Type type() const override { return Term::Type::Variable; }
-        std::string toSMTLIB() const override;
         virtual std::string prettyString() const override;
-        
-        static unsigned freshId;
     };
     
     class FuncTerm : public Term
     {
         friend class Terms;
-        FuncTerm(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms) : Term(symbol), subterms(std::move(subterms))
+        template<typename> friend class NodeAllocator;
+        FuncTerm(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, unsigned id, std::size_t hash) : Term(symbol, id, hash), subterms(std::move(subterms))
         {
             assert(this->symbol->argSorts.size() == this->subterms.size());
             for (int i=0; i < this->symbol->argSorts.size(); ++i)
@@ -67,11 +74,10 @@ namespace logic {
         const std::vector<std::shared_ptr<const Term>> subterms;
         
         Type type() const override { return Term::Type::FuncTerm; }
-        std::string toSMTLIB() const override;
         virtual std::string prettyString() const override;
     };
     
-    inline std::ostream& operator<<(std::ostream& ostr, const Term& e) { ostr << e.toSMTLIB(); return ostr; }
+    std::ostream& operator<<(std::ostream& ostr, const Term& e);
 
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Term>>& t);
@@ -86,43 +92,59 @@ namespace std
         using argument_type = const logic::Term;
         using result_type = std::size_t;
 
+        // the structural hash is computed once during construction of the term
         result_type operator ()(argument_type const& t) const
         {
-            // start from symbol of term
-            size_t result = std::hash<const logic::Symbol>()(*t.symbol);
-            // then integrate type into the hash
-            result ^= std::hash<logic::Term::Type>()(t.type()) + 0x9e3779b9 + (result << 6) + (result >> 2);
-            if (t.type() == logic::Term::Type::Variable)
-            {
-                // for an LVariable, finally integrate id into the hash
-                auto castedTerm = dynamic_cast<const logic::LVariable&>(t);
-                result ^= std::hash<unsigned>()(castedTerm.id) + 0x9e3779b9 + (result << 6) + (result >> 2);
-            }
-            else
-            {
-                // for a FuncTerm, integrate each subterm into the hash
-                auto castedTerm = dynamic_cast<const logic::FuncTerm&>(t);
-                for (const auto& subterm : castedTerm.subterms)
-                {
-                    result ^= std::hash<const logic::Term>()(*subterm) + 0x9e3779b9 + (result << 6) + (result >> 2);
-                }
-            }
-            return result;
+            return t.hash;
         }
     };
 }
 
 # pragma mark - Terms
 namespace logic {
-    // We use Terms as a manager-class for Term-instances
+    // We use Terms as a manager-class for Term-instances.
+    // Terms are hash-consed: each structurally distinct term is constructed only once and is afterwards fetched from the term bank,
+    // so two terms are structurally equal if and only if they are the same object.
     class Terms
     {
     public:
 
-        // construct new terms
-        static std::shared_ptr<const LVariable> var(std::shared_ptr<const Symbol> symbol);
-        static std::shared_ptr<const FuncTerm> func(std::string name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration=false);
-        static std::shared_ptr<const FuncTerm> func(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms);
+        // construct new terms (or fetch them from the term bank, if they have been constructed before)
+        static std::shared_ptr<const LVariable> var(const std::shared_ptr<const Symbol>& symbol);
+        static std::shared_ptr<const FuncTerm> func(const std::string& name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration=false);
+        static std::shared_ptr<const FuncTerm> func(const std::shared_ptr<const Symbol>& symbol, std::vector<std::shared_ptr<const Term>> subterms);
+
+    private:
+        // a function term is identified by its top-level symbol and its (already hash-consed) subterms.
+        // the key additionally stores the structural hash of the term, which is used both for the lookup and for the constructed term.
+        struct FuncTermKey
+        {
+            std::size_t hash;
+            const Symbol* symbol;
+            std::vector<const Term*> subterms;
+
+            bool operator==(const FuncTermKey& o) const { return symbol == o.symbol && subterms == o.subterms; }
+        };
+
+        class FuncTermKeyHash {
+        public:
+            std::size_t operator ()(const FuncTermKey& key) const { return key.hash; }
+        };
+
+    public:
+        // the term bank of a LogicContext: all terms constructed so far.
+        struct State
+        {
+            // variables are identified by their (interned) symbol
+            std::unordered_map<unsigned, std::shared_ptr<const LVariable>> vars;
+            std::unordered_map<FuncTermKey, std::shared_ptr<const FuncTerm>, FuncTermKeyHash> funcTerms;
+            // the id which will be assigned to the next constructed term
+            unsigned nextId = 0;
+        };
+
+    private:
+        // the state of the current LogicContext
+        static State& state();
     };
 }
 #endif
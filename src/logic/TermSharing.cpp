@@ -0,0 +1,347 @@
+#include "TermSharing.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+namespace logic {
+
+    // depth of terms containing a variable which is not bound by any quantifier. Such terms are never shared.
+    static const unsigned unboundDepth = UINT_MAX;
+
+    TermSharing::TermSharing(const std::vector<const Formula*>& formulas)
+    {
+        frames.push_back({nullptr, 0, {}, {}});
+        for (const auto& f : formulas)
+        {
+            std::unordered_set<std::string> bound;
+            if (rebindsVariable(*f, bound))
+            {
+                _excluded.insert(f);
+                continue;
+            }
+            visit(*f, 3);
+
+            // terms with unbound variables could be bound in the next formula, so forget them
+            for (const auto& t : frames[0].cachedTerms)
+            {
+                depths.erase(t);
+            }
+            frames[0].cachedTerms.clear();
+        }
+        _closedTerms = sharedTerms(frames[0]);
+    }
+
+    const std::vector<const Term*>& TermSharing::letTerms(const Formula& f) const
+    {
+        static const std::vector<const Term*> noTerms;
+        auto it = _letTerms.find(&f);
+        return it == _letTerms.end() ? noTerms : it->second;
+    }
+
+    bool TermSharing::rebindsVariable(const Formula& f, std::unordered_set<std::string>& bound) const
+    {
+        switch (f.type())
+        {
+            case Formula::Type::Conjunction:
+            {
+                for (const auto& conj : static_cast<const ConjunctionFormula&>(f).conj)
+                {
+                    if (rebindsVariable(*conj, bound)) return true;
+                }
+                return false;
+            }
+            case Formula::Type::Disjunction:
+            {
+                for (const auto& disj : static_cast<const DisjunctionFormula&>(f).disj)
+                {
+                    if (rebindsVariable(*disj, bound)) return true;
+                }
+                return false;
+            }
+            case Formula::Type::Negation:
+                return rebindsVariable(*static_cast<const NegationFormula&>(f).f, bound);
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                return rebindsVariable(*castedFormula.f1, bound) || rebindsVariable(*castedFormula.f2, bound);
+            }
+            case Formula::Type::Equivalence:
+            {
+                auto& castedFormula = static_cast<const EquivalenceFormula&>(f);
+                return rebindsVariable(*castedFormula.f1, bound) || rebindsVariable(*castedFormula.f2, bound);
+            }
+            case Formula::Type::Existential:
+            case Formula::Type::Universal:
+            {
+                bool isExistential = f.type() == Formula::Type::Existential;
+                const auto& vars = isExistential ? static_cast<const ExistentialFormula&>(f).vars : static_cast<const UniversalFormula&>(f).vars;
+                const auto& subformula = isExistential ? static_cast<const ExistentialFormula&>(f).f : static_cast<const UniversalFormula&>(f).f;
+                std::vector<std::string> added;
+                bool rebinds = false;
+                for (const auto& var : vars)
+                {
+                    if (!bound.insert(var->name).second)
+                    {
+                        rebinds = true;
+                        break;
+                    }
+                    added.push_back(var->name);
+                }
+                rebinds = rebinds || rebindsVariable(*subformula, bound);
+                for (const auto& name : added)
+                {
+                    bound.erase(name);
+                }
+                return rebinds;
+            }
+            default:
+                return false;
+        }
+    }
+
+    void TermSharing::visit(const Formula& f, unsigned indentation)
+    {
+        switch (f.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                for (const auto& subterm : static_cast<const PredicateFormula&>(f).subterms)
+                {
+                    visit(*subterm);
+                }
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedFormula = static_cast<const EqualityFormula&>(f);
+                visit(*castedFormula.left);
+                visit(*castedFormula.right);
+                break;
+            }
+            case Formula::Type::Conjunction:
+            {
+                for (const auto& conj : static_cast<const ConjunctionFormula&>(f).conj)
+                {
+                    visit(*conj, indentation + 3);
+                }
+                break;
+            }
+            case Formula::Type::Disjunction:
+            {
+                for (const auto& disj : static_cast<const DisjunctionFormula&>(f).disj)
+                {
+                    visit(*disj, indentation + 3);
+                }
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                visit(*static_cast<const NegationFormula&>(f).f, indentation + 3);
+                break;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                visit(*castedFormula.f1, indentation + 3);
+                visit(*castedFormula.f2, indentation + 3);
+                break;
+            }
+            case Formula::Type::Equivalence:
+            {
+                auto& castedFormula = static_cast<const EquivalenceFormula&>(f);
+                visit(*castedFormula.f1, indentation + 3);
+                visit(*castedFormula.f2, indentation + 3);
+                break;
+            }
+            case Formula::Type::Existential:
+            case Formula::Type::Universal:
+            {
+                bool isExistential = f.type() == Formula::Type::Existential;
+                const auto& vars = isExistential ? static_cast<const ExistentialFormula&>(f).vars : static_cast<const UniversalFormula&>(f).vars;
+                const auto& subformula = isExistential ? static_cast<const ExistentialFormula&>(f).f : static_cast<const UniversalFormula&>(f).f;
+
+                frames.push_back({&f, indentation + 3, {}, {}});
+                for (const auto& var : vars)
+                {
+                    boundVariables[var->name] = frames.size() - 1;
+                }
+                visit(*subformula, indentation + 3);
+                for (const auto& var : vars)
+                {
+                    boundVariables.erase(var->name);
+                }
+                popFrame();
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void TermSharing::visit(const Term& t)
+    {
+        if (t.type() != Term::Type::FuncTerm)
+        {
+            return;
+        }
+        auto& castedTerm = static_cast<const FuncTerm&>(t);
+        if (castedTerm.subterms.empty())
+        {
+            return;
+        }
+
+        auto d = depth(t);
+        if (d != unboundDepth)
+        {
+            // count the subterms only once, assuming that the term will be shared.
+            // if it turns out that the term is not worth sharing, the remaining occurrences are added later.
+            if (++frames[d].occurrences[&t] > 1)
+            {
+                return;
+            }
+        }
+        for (const auto& subterm : castedTerm.subterms)
+        {
+            visit(*subterm);
+        }
+    }
+
+    unsigned TermSharing::depth(const Term& t)
+    {
+        auto it = depths.find(&t);
+        if (it != depths.end())
+        {
+            return it->second;
+        }
+
+        unsigned d = 0;
+        if (t.type() == Term::Type::Variable || static_cast<const FuncTerm&>(t).subterms.empty())
+        {
+            // variables are either proper variables or constants whose symbol is not declared in the signature
+            auto variable = boundVariables.find(t.symbol->name);
+            if (variable != boundVariables.end())
+            {
+                d = variable->second;
+            }
+            else if (t.type() == Term::Type::Variable || !Signature::isDeclared(t.symbol->name))
+            {
+                d = unboundDepth;
+            }
+        }
+        else
+        {
+            for (const auto& subterm : static_cast<const FuncTerm&>(t).subterms)
+            {
+                d = std::max(d, depth(*subterm));
+            }
+        }
+
+        depths[&t] = d;
+        if (d != 0)
+        {
+            // the depth is only valid as long as the frame binding the variables is active
+            (d == unboundDepth ? frames.back() : frames[d]).cachedTerms.push_back(&t);
+        }
+        return d;
+    }
+
+    void TermSharing::popFrame()
+    {
+        assert(frames.size() > 1);
+        auto& frame = frames.back();
+
+        auto terms = sharedTerms(frame);
+        if (!terms.empty())
+        {
+            _letTerms[frame.quantifier] = std::move(terms);
+        }
+        for (const auto& t : frame.cachedTerms)
+        {
+            depths.erase(t);
+        }
+        frames.pop_back();
+    }
+
+    unsigned TermSharing::length(const Term& t)
+    {
+        auto it = lengths.find(&t);
+        if (it != lengths.end())
+        {
+            return it->second;
+        }
+        unsigned l = t.symbol->toSMTLIB().size();
+        if (t.type() == Term::Type::FuncTerm && !static_cast<const FuncTerm&>(t).subterms.empty())
+        {
+            // parentheses and separating spaces
+            l += 2;
+            for (const auto& subterm : static_cast<const FuncTerm&>(t).subterms)
+            {
+                l += 1 + length(*subterm);
+            }
+        }
+        lengths[&t] = l;
+        return l;
+    }
+
+    void TermSharing::addOccurrences(const Term& t, unsigned occurrences)
+    {
+        if (t.type() != Term::Type::FuncTerm || static_cast<const FuncTerm&>(t).subterms.empty())
+        {
+            return;
+        }
+        auto d = depth(t);
+        if (d != unboundDepth)
+        {
+            frames[d].occurrences[&t] += occurrences;
+        }
+        else
+        {
+            for (const auto& subterm : static_cast<const FuncTerm&>(t).subterms)
+            {
+                addOccurrences(*subterm, occurrences);
+            }
+        }
+    }
+
+    std::vector<const Term*> TermSharing::sharedTerms(Frame& frame)
+    {
+        // decide for each term before deciding for its subterms, which have smaller ids.
+        // note: addOccurrences only changes the number of occurrences of terms which have already been visited.
+        std::vector<const Term*> candidates;
+        for (const auto& pair : frame.occurrences)
+        {
+            candidates.push_back(pair.first);
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Term* t1, const Term* t2) { return t1->id > t2->id; });
+
+        std::vector<const Term*> terms;
+        for (const auto& t : candidates)
+        {
+            auto occurrences = frame.occurrences[t];
+            if (occurrences < 2)
+            {
+                continue;
+            }
+            // only share the term if this makes the output smaller.
+            // a let-binding costs 12 characters plus name and indentation, a define-fun 20 characters plus name and sort.
+            auto nameLength = name(*t).size();
+            auto termLength = length(*t);
+            auto definitionLength = nameLength + (frame.quantifier != nullptr ? 12 + frame.indentation : 20 + t->symbol->rngSort->toSMTLIB().size());
+            if (termLength > nameLength && (occurrences - 1) * (termLength - nameLength) > definitionLength)
+            {
+                terms.push_back(t);
+            }
+            else
+            {
+                // the term is printed at each occurrence, so its subterms occur more often than counted so far
+                for (const auto& subterm : static_cast<const FuncTerm*>(t)->subterms)
+                {
+                    addOccurrences(*subterm, occurrences - 1);
+                }
+            }
+        }
+        std::sort(terms.begin(), terms.end(), [](const Term* t1, const Term* t2) { return t1->id < t2->id; });
+        return terms;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef __TermSharing__
+#define __TermSharing__
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Term.hpp"
+#include "Formula.hpp"
+
+namespace logic {
+
+    /*
+     * detects subterms which occur several times in a set of formulas (usually the formulas of a single reasoning task),
+     * so that SMTLIBWriter can print each of them only once:
+     * - closed terms (i.e. terms without variables) are shared across all formulas using a define-fun,
+     * - open terms are shared using a let-binding directly below the innermost quantifier binding one of their variables.
+     * occurrences are counted on the DAG, i.e. the subterms of a shared term are only counted once, since the shared
+     * term is printed only once. A term is only shared if this makes the output smaller.
+     * note: formulas containing a quantifier which rebinds a variable which is already bound are not analyzed, so
+     * they don't get any let-bindings (they can still use the define-funs).
+     */
+    class TermSharing
+    {
+    public:
+        TermSharing(const std::vector<const Formula*>& formulas);
+
+        // the closed terms which should be defined using a define-fun, ordered by id (so each term comes after its subterms)
+        const std::vector<const Term*>& closedTerms() const { return _closedTerms; }
+        // the open terms which should be let-bound directly below the quantified formula 'f', ordered by id
+        const std::vector<const Term*>& letTerms(const Formula& f) const;
+        // true iff 'f' is one of the formulas which could not be analyzed
+        bool isExcluded(const Formula& f) const { return _excluded.find(&f) != _excluded.end(); }
+
+        // the name used in the output for a shared term
+        static std::string name(const Term& t) { return "t!" + std::to_string(t.id); }
+
+    private:
+        // a frame collects the occurrences of terms which belong to a quantifier (or, for the first frame, the closed terms)
+        struct Frame
+        {
+            const Formula* quantifier;
+            // the indentation of the let-bindings
+            unsigned indentation;
+            std::unordered_map<const Term*, unsigned> occurrences;
+            // terms for which the depth has been cached while this frame was active and which depend on it
+            std::vector<const Term*> cachedTerms;
+        };
+
+        std::vector<Frame> frames;
+        // maps each bound variable to the index of the frame of the quantifier binding it
+        std::unordered_map<std::string, unsigned> boundVariables;
+        // caches the depth (the index of the innermost frame binding a variable) of each visited term
+        std::unordered_map<const Term*, unsigned> depths;
+        // caches the length of the SMTLIB-string of each visited term
+        std::unordered_map<const Term*, unsigned> lengths;
+
+        std::vector<const Term*> _closedTerms;
+        std::unordered_map<const Formula*, std::vector<const Term*>> _letTerms;
+        std::unordered_set<const Formula*> _excluded;
+
+        bool rebindsVariable(const Formula& f, std::unordered_set<std::string>& bound) const;
+        void visit(const Formula& f, unsigned indentation);
+        void visit(const Term& t);
+        unsigned depth(const Term& t);
+        unsigned length(const Term& t);
+        void popFrame();
+        void addOccurrences(const Term& t, unsigned occurrences);
+        // decide which of the terms of the frame are shared
+        std::vector<const Term*> sharedTerms(Frame& frame);
+    };
+}
+
+#endif
@@ -32,47 +32,47 @@ namespace logic {
         return Terms::func(std::to_string(i), {}, Sorts::intSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::intAddition(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
+    std::shared_ptr<const FuncTerm> Theory::intAddition(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2)
     {
         return Terms::func("+", {t1,t2}, Sorts::intSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::intSubtraction(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
+    std::shared_ptr<const FuncTerm> Theory::intSubtraction(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2)
     {
         return Terms::func("-", {t1,t2}, Sorts::intSort(), true);
     }
 
-    std::shared_ptr<const FuncTerm> Theory::intModulo(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
+    std::shared_ptr<const FuncTerm> Theory::intModulo(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2)
     {
         return Terms::func("mod", {t1,t2}, Sorts::intSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::intMultiplication(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
+    std::shared_ptr<const FuncTerm> Theory::intMultiplication(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2)
     {
         return Terms::func("*", {t1,t2}, Sorts::intSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::intAbsolute(std::shared_ptr<const Term> t)
+    std::shared_ptr<const FuncTerm> Theory::intAbsolute(const std::shared_ptr<const Term>& t)
     {
         return Terms::func("abs", {t}, Sorts::intSort(), true);
     }
     
-    std::shared_ptr<const Formula> Theory::intLess(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
+    std::shared_ptr<const Formula> Theory::intLess(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label)
     {
         return Formulas::predicate("<", {t1,t2}, label, true);
     }
     
-    std::shared_ptr<const Formula> Theory::intLessEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
+    std::shared_ptr<const Formula> Theory::intLessEqual(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label)
     {
         return Formulas::predicate("<=", {t1,t2}, label, true);
     }
 
-    std::shared_ptr<const Formula> Theory::intGreater(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2,  std::string label)
+    std::shared_ptr<const Formula> Theory::intGreater(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2,  std::string label)
     {
         return Formulas::predicate(">", {t1,t2}, label, true);
     }
     
-    std::shared_ptr<const Formula> Theory::intGreaterEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
+    std::shared_ptr<const Formula> Theory::intGreaterEqual(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label)
     {
         return Formulas::predicate(">=", {t1,t2}, label, true);
     }
@@ -92,23 +92,23 @@ namespace logic {
         return Terms::func("zero", {}, Sorts::natSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::natSucc(std::shared_ptr<const Term> term)
+    std::shared_ptr<const FuncTerm> Theory::natSucc(const std::shared_ptr<const Term>& term)
     {
         return Terms::func("s", {term}, Sorts::natSort(), true);
     }
     
-    std::shared_ptr<const FuncTerm> Theory::natPre(std::shared_ptr<const Term> term)
+    std::shared_ptr<const FuncTerm> Theory::natPre(const std::shared_ptr<const Term>& term)
     {
         return Terms::func("p", {term}, Sorts::natSort(), true);
     }
     
-    std::shared_ptr<const Formula> Theory::natSub(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
+    std::shared_ptr<const Formula> Theory::natSub(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label)
     {
         bool alreadyDeclared = util::Configuration::instance().nativeNat();
         return Formulas::predicate("Sub", {t1,t2}, label, alreadyDeclared);
     }
     
-    std::shared_ptr<const Formula> Theory::natSubEq(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
+    std::shared_ptr<const Formula> Theory::natSubEq(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label)
     {
         // encode t1<=t2 as t1 < s(t2).
         return Theory::natSub(t1,natSucc(t2), label);
@@ -126,6 +126,8 @@ namespace logic {
         std::vector<std::shared_ptr<const Symbol>> freeVarSymbols, 
         ProblemItem::Visibility visibility)
     {
+        ItemOrigin::Scope originScope(ItemOrigin::current().withKind("inductionAxiom1"));
+
         auto boundLSymbol = logic::Signature::varSymbol("boundL", logic::Sorts::natSort());
         auto boundRSymbol = logic::Signature::varSymbol("boundR", logic::Sorts::natSort());
         auto itIndSymbol = logic::Signature::varSymbol("itInd", logic::Sorts::natSort());
@@ -222,6 +224,8 @@ namespace logic {
         std::vector<std::shared_ptr<const Symbol>> freeVarSymbols,
         ProblemItem::Visibility visibility)
     {
+        ItemOrigin::Scope originScope(ItemOrigin::current().withKind("inductionAxiom2"));
+
         auto itIndSymbol = logic::Signature::varSymbol("itInd", logic::Sorts::natSort());
         auto itInd = Terms::var(itIndSymbol);
 
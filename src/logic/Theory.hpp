@@ -18,25 +18,25 @@ namespace logic {
         static void declareTheories();
         
         static std::shared_ptr<const FuncTerm> intConstant(int i);
-        static std::shared_ptr<const FuncTerm> intAddition(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2);
-        static std::shared_ptr<const FuncTerm> intSubtraction(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2);
-        static std::shared_ptr<const FuncTerm> intModulo(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2);
-        static std::shared_ptr<const FuncTerm> intMultiplication(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2);
-        static std::shared_ptr<const FuncTerm> intAbsolute(std::shared_ptr<const Term> t);
+        static std::shared_ptr<const FuncTerm> intAddition(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2);
+        static std::shared_ptr<const FuncTerm> intSubtraction(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2);
+        static std::shared_ptr<const FuncTerm> intModulo(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2);
+        static std::shared_ptr<const FuncTerm> intMultiplication(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2);
+        static std::shared_ptr<const FuncTerm> intAbsolute(const std::shared_ptr<const Term>& t);
 
-        static std::shared_ptr<const Formula> intLess(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
-        static std::shared_ptr<const Formula> intLessEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
-        static std::shared_ptr<const Formula> intGreater(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
-        static std::shared_ptr<const Formula> intGreaterEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
+        static std::shared_ptr<const Formula> intLess(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
+        static std::shared_ptr<const Formula> intLessEqual(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
+        static std::shared_ptr<const Formula> intGreater(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
+        static std::shared_ptr<const Formula> intGreaterEqual(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
         
         static std::shared_ptr<const Formula> boolTrue(std::string label="");
         static std::shared_ptr<const Formula> boolFalse(std::string label="");
 
         static std::shared_ptr<const FuncTerm> natZero();
-        static std::shared_ptr<const FuncTerm> natSucc(std::shared_ptr<const Term> term);
-        static std::shared_ptr<const FuncTerm> natPre(std::shared_ptr<const Term> term);
-        static std::shared_ptr<const Formula> natSub(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
-        static std::shared_ptr<const Formula> natSubEq(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
+        static std::shared_ptr<const FuncTerm> natSucc(const std::shared_ptr<const Term>& term);
+        static std::shared_ptr<const FuncTerm> natPre(const std::shared_ptr<const Term>& term);
+        static std::shared_ptr<const Formula> natSub(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
+        static std::shared_ptr<const Formula> natSubEq(const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2, std::string label="");
     };
     
     /*
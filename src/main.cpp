@@ -1,27 +1,428 @@
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "logic/LogicContext.hpp"
 #include "logic/Theory.hpp"
 #include "logic/Problem.hpp"
-
-#include "program/Program.hpp"
+#include "logic/SizeReport.hpp"
 
 #include "util/Options.hpp"
 #include "util/Output.hpp"
+#include "util/ProverRunner.hpp"
+#include "util/Statistics.hpp"
+#include "util/Trace.hpp"
+#include "util/ThreadPool.hpp"
 
-#include "parser/WhileParserWrapper.hpp"
-
-#include "analysis/Semantics.hpp"
-#include "analysis/TraceLemmas.hpp"
-#include "analysis/TheoryAxioms.hpp"
+#include "api/Rapid.hpp"
 
 void outputUsage()
 {
     std::cout << "Usage: rapid -dir <outputDir> <filename>" << std::endl;
+    std::cout << "       rapid -server on <socketPath or - for stdin>" << std::endl;
+}
+
+/*
+ * run the prover given by the options on the generated files (see util::ProverRunner::run), using 'numberOfThreads'
+ * prover processes at the same time, and write a summary of the results into outputDir/results.txt.
+ */
+void proveReasoningTasks(const std::vector<std::string>& files, const std::vector<std::vector<std::string>>& checks, const std::string& outputDir, unsigned numberOfThreads, std::ostream& log)
+{
+    util::Statistics::ScopedTimer timer("prover");
+    auto& configuration = util::Configuration::instance();
+    util::ProverRunner runner(configuration.prover(), configuration.proverTimeout(), configuration.proverMemoryLimit(), numberOfThreads, configuration.proverCache());
+    auto results = runner.run(files, checks);
+
+    auto summaryFile = outputDir + "results.txt";
+    std::ofstream summary(summaryFile);
+    runner.writeSummary(summary, results);
+
+    auto numberOfProven = std::count_if(results.begin(), results.end(), [](const util::ProverResult& result) { return result.isProven(); });
+    auto numberOfCached = std::count_if(results.begin(), results.end(), [](const util::ProverResult& result) { return result.isCached; });
+    log << "Proved " << numberOfProven << " of " << results.size() << " reasoning tasks";
+    if (configuration.proverCache() != "")
+    {
+        log << " (" << numberOfCached << " results from cache)";
+    }
+    log << ", results in " << summaryFile << "\n";
+}
+
+/*
+ * generate the reasoning tasks for the spec 'inputFile' and output them into 'outputDir', using the current logic context.
+ * returns false if the spec could not be parsed or if an output file already exists.
+ */
+bool generateReasoningTasks(const std::string& inputFile, const std::string& outputDir, unsigned numberOfThreads, std::ostream& log)
+{
+    auto inputFileWithoutExtension = inputFile.substr(0, inputFile.find_last_of('.'));
+
+    // read inputFile
+    std::ifstream istr(inputFile);
+    if (!istr)
+    {
+        std::cerr << "Unable to read file " << inputFile << std::endl;
+        return false;
+    }
+    std::stringstream specText;
+    specText << istr.rdbuf();
+    
+    // generate reasoning tasks, convert each reasoning task to smtlib, and output it to output-file
+    std::vector<logic::ReasoningTask> tasks;
+    std::string preamble;
+    if (!api::generateReasoningTasks(specText.str(), inputFile, log, tasks, preamble))
+    {
+        return false;
+    }
+    // the generated files, and the names of the tasks checked by each of them
+    std::vector<std::string> files;
+    std::vector<std::vector<std::string>> checks;
+    util::Statistics::ScopedTimer outputTimer("output");
+    if (util::Configuration::instance().incremental())
+    {
+        // name the script after the input file
+        auto name = inputFileWithoutExtension.substr(inputFileWithoutExtension.find_last_of('/') + 1);
+        files.push_back(outputDir + name + ".smt2");
+        if (!logic::outputIncrementalSMTLIBToFile(tasks, files.back(), preamble, log))
+        {
+            return false;
+        }
+        checks.emplace_back();
+        for (const auto& task : tasks)
+        {
+            checks.back().push_back(task.conjecture->name);
+        }
+    }
+    else
+    {
+        if (!logic::outputSMTLIBToDir(tasks, outputDir, preamble, numberOfThreads, log))
+        {
+            return false;
+        }
+        for (const auto& task : tasks)
+        {
+            files.push_back(task.outputFileName(outputDir));
+            checks.push_back({task.conjecture->name});
+        }
+    }
+    outputTimer.stop();
+
+    if (util::Configuration::instance().sizeReport())
+    {
+        util::Statistics::ScopedTimer timer("size-report");
+        auto reportFile = outputDir + "size-report.json";
+        std::ofstream report(reportFile);
+        logic::outputSizeReport(tasks, report);
+        log << "Generating size report in " << reportFile << "\n";
+    }
+
+    if (util::Configuration::instance().prover() != "")
+    {
+        proveReasoningTasks(files, checks, outputDir, numberOfThreads, log);
+    }
+    return true;
+}
+
+/*
+ * batch mode: 'input' is either a directory, in which case all specs in it (and its subdirectories) are processed,
+ * or a file listing the specs to process (one per line).
+ * the tasks of each spec are output into its own subdirectory of 'outputDir', mirroring the path of the spec.
+ * the specs are processed in parallel, each in its own logic context. Only parsing is serialized, since the scanner
+ * generated by Flex uses global state (see parser::parserMutex). Returns false if any spec could not be processed.
+ */
+bool generateReasoningTasksForBatch(const std::string& input, const std::string& outputDir, unsigned numberOfThreads)
+{
+    std::vector<std::string> inputFiles;
+    if (std::filesystem::is_directory(input))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".spec")
+            {
+                inputFiles.push_back(entry.path().string());
+            }
+        }
+        std::sort(inputFiles.begin(), inputFiles.end());
+    }
+    else
+    {
+        std::ifstream list(input);
+        if (!list)
+        {
+            std::cout << "Error: Unable to read file " << input << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(list, line))
+        {
+            if (!line.empty())
+            {
+                inputFiles.push_back(line);
+            }
+        }
+    }
+
+    // the tasks of each spec are output into a directory mirroring the path of the spec relative to the input directory
+    // (resp. the current directory), e.g. the tasks of arrays/find.spec are output into outputDir/arrays/find/.
+    // specs outside of it are mirrored by their absolute path. Two specs can't share a directory.
+    auto baseDir = std::filesystem::absolute(std::filesystem::is_directory(input) ? std::filesystem::path(input) : std::filesystem::current_path());
+    std::vector<std::string> specOutputDirs;
+    std::unordered_set<std::string> usedOutputDirs;
+    for (const auto& inputFile : inputFiles)
+    {
+        auto path = std::filesystem::absolute(inputFile).lexically_normal();
+        auto relativePath = path.lexically_relative(baseDir);
+        if (relativePath.empty() || *relativePath.begin() == "..")
+        {
+            relativePath = path.relative_path();
+        }
+        auto specOutputDir = outputDir + relativePath.replace_extension("").string() + "/";
+        specOutputDirs.push_back(usedOutputDirs.insert(specOutputDir).second ? specOutputDir : "");
+    }
+
+    std::vector<std::stringstream> logs(inputFiles.size());
+    std::vector<char> succeeded(inputFiles.size(), false);
+    std::vector<std::future<void>> results;
+    util::ThreadPool pool(std::max(numberOfThreads, 1u));
+    for (unsigned i = 0; i < inputFiles.size(); ++i)
+    {
+        results.push_back(pool.submit([&, i]
+        {
+            const auto& inputFile = inputFiles[i];
+            const auto& specOutputDir = specOutputDirs[i];
+            util::Trace::Span span("spec", util::Trace::isEnabled() ? inputFile : "");
+
+            if (specOutputDir.empty())
+            {
+                logs[i] << "Error: The output directory of " << inputFile << " is already used by another spec!" << std::endl;
+                return;
+            }
+            std::filesystem::create_directories(specOutputDir);
+
+            // the symbols, sorts and terms of the spec only live during its processing
+            logic::LogicContext context;
+            logic::LogicContext::Scope scope(context);
+            succeeded[i] = generateReasoningTasks(inputFile, specOutputDir, 1, logs[i]);
+        }));
+    }
+
+    // report the specs in order, as soon as they are finished
+    bool success = true;
+    for (unsigned i = 0; i < inputFiles.size(); ++i)
+    {
+        results[i].get();
+        std::cout << (succeeded[i] ? "Processed " : "Error: Could not process ") << inputFiles[i] << "\n" << logs[i].str() << std::flush;
+        success = success && succeeded[i];
+    }
+    return success;
+}
+
+#pragma mark - Server
+
+/*
+ * the messages of the server are framed: each message consists of its length in bytes (as decimal number) followed by
+ * a newline and the content of the message.
+ * the content of a request is the text of a spec. The content of the reply is either
+ * - "ok <numberOfTasks>\n" followed by "<conjectureName> <length>\n<smtlib>" for each task, or
+ * - "error\n" followed by the error messages.
+ * requests larger than -serverMaxRequestSize megabytes are answered with an error, and the connection is closed.
+ */
+namespace
+{
+    bool readAll(int fd, char* buffer, std::size_t size)
+    {
+        while (size > 0)
+        {
+            auto n = read(fd, buffer, size);
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR) continue;
+                return false;
+            }
+            buffer += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool writeAll(int fd, const char* buffer, std::size_t size)
+    {
+        while (size > 0)
+        {
+            auto n = write(fd, buffer, size);
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR) continue;
+                return false;
+            }
+            buffer += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    // read the length prefix of a message. Returns false at the end of the input or if the prefix is malformed
+    bool readLength(int fd, unsigned long long& length)
+    {
+        std::string digits;
+        char c;
+        while (true)
+        {
+            if (!readAll(fd, &c, 1))
+            {
+                return false;
+            }
+            if (c == '\n')
+            {
+                break;
+            }
+            if (!std::isdigit(static_cast<unsigned char>(c)) || digits.size() >= 18)
+            {
+                return false;
+            }
+            digits += c;
+        }
+        if (digits.empty())
+        {
+            return false;
+        }
+        length = std::stoull(digits);
+        return true;
+    }
+
+    bool writeMessage(int fd, const std::string& message)
+    {
+        auto length = std::to_string(message.size()) + "\n";
+        return writeAll(fd, length.data(), length.size()) && writeAll(fd, message.data(), message.size());
+    }
+
+    /*
+     * generate the reasoning tasks for the spec given as text in 'context', and return the reply to the request.
+     * an exception thrown while processing the request is reported in the reply instead of terminating the server.
+     * afterwards the context is reset, so that its memory is reused by the next request.
+     */
+    std::string handleRequest(const std::string& specText, logic::LogicContext& context)
+    {
+        std::stringstream reply;
+        try
+        {
+            logic::LogicContext::Scope scope(context);
+
+            std::stringstream errors;
+            std::vector<logic::ReasoningTask> tasks;
+            std::string preamble;
+            if (!api::generateReasoningTasks(specText, "request", errors, tasks, preamble))
+            {
+                reply << "error\n" << errors.str();
+            }
+            else
+            {
+                reply << "ok " << tasks.size() << "\n";
+                for (const auto& task : tasks)
+                {
+                    std::stringstream smtlib;
+                    task.outputSMTLIB(smtlib, preamble);
+                    reply << task.conjecture->name << " " << smtlib.str().size() << "\n" << smtlib.str();
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            reply.str("");
+            reply << "error\n" << "Error: " << e.what() << "\n";
+        }
+        context.reset();
+        return reply.str();
+    }
+
+    void serveConnection(int inFd, int outFd, logic::LogicContext& context)
+    {
+        auto maxRequestSize = static_cast<unsigned long long>(util::Configuration::instance().serverMaxRequestSize()) * 1024 * 1024;
+        std::string request;
+        unsigned long long length;
+        while (readLength(inFd, length))
+        {
+            // a request which is too large is rejected without reading it, and the connection is closed
+            if (length > maxRequestSize)
+            {
+                writeMessage(outFd, "error\nError: The request of " + std::to_string(length) + " bytes exceeds the limit of " + std::to_string(maxRequestSize) + " bytes\n");
+                return;
+            }
+            request.resize(length);
+            if (!readAll(inFd, &request[0], request.size()) || !writeMessage(outFd, handleRequest(request, context)))
+            {
+                return;
+            }
+        }
+    }
+}
+
+/*
+ * server mode: process requests until the input ends (if 'address' is "-", requests are read from stdin and replies
+ * are written to stdout) or forever (otherwise 'address' is the path of a UNIX domain socket, which is created).
+ * all requests are processed one after another in the same logic context, so its memory is reused. The options are
+ * parsed once, but the symbols of the theories are not kept across requests: as in the other modes they are declared
+ * on first use, since declaring them up front (see Theory::declareTheories) would e.g. add the sort Nat to every task.
+ */
+bool runServer(const std::string& address)
+{
+    signal(SIGPIPE, SIG_IGN);
+    logic::LogicContext context;
+
+    if (address == "-")
+    {
+        // keep stdout for the replies, and redirect all other output to stderr
+        int replyFd = dup(STDOUT_FILENO);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        serveConnection(STDIN_FILENO, replyFd, context);
+        close(replyFd);
+        return true;
+    }
+
+    sockaddr_un socketAddress{};
+    socketAddress.sun_family = AF_UNIX;
+    if (address.size() >= sizeof(socketAddress.sun_path))
+    {
+        std::cout << "Error: socket path " << address << " is too long" << std::endl;
+        return false;
+    }
+    std::strcpy(socketAddress.sun_path, address.c_str());
+
+    int socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(address.c_str());
+    if (socketFd < 0 || bind(socketFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0 || listen(socketFd, 16) != 0)
+    {
+        std::cout << "Error: unable to listen on socket " << address << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::cout << "Listening on " << address << std::endl;
+    while (true)
+    {
+        int connectionFd = accept(socketFd, nullptr, nullptr);
+        if (connectionFd < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cout << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        serveConnection(connectionFd, connectionFd, context);
+        close(connectionFd);
+    }
 }
 
 int main(int argc, char *argv[])
@@ -37,15 +438,11 @@ int main(int argc, char *argv[])
             if (util::Output::initialize())
             {
                 std::string inputFile = argv[argc - 1];
-                
-                // check that inputFile ends in ".spec"
-                std::string extension = ".spec";
-                assert(inputFile.size() > extension.size());
-                assert(inputFile.compare(inputFile.size()-extension.size(), extension.size(),extension) == 0);
-                auto inputFileWithoutExtension = inputFile.substr(0,inputFile.size()-extension.size());
-
-                // parse inputFile
-                auto parserResult = parser::parse(inputFile);
+
+                if (util::Configuration::instance().server())
+                {
+                    return runServer(inputFile) ? 0 : 1;
+                }
                 
                 // setup outputDir
                 auto outputDir = util::Configuration::instance().outputDir();
@@ -54,37 +451,46 @@ int main(int argc, char *argv[])
                     std::cout << "Error: dir parameter required" << std::endl;
                     exit(1);
                 }
-                
-                // generate problem
-                std::vector<std::shared_ptr<const logic::ProblemItem>> problemItems;
-                
-                analysis::TheoryAxioms theoryAxiomsGenerator;
-                auto theoryAxioms = theoryAxiomsGenerator.generate();
-                for (const auto& axiom : theoryAxioms)
+
+                if (util::Configuration::instance().stats())
                 {
-                    problemItems.push_back(axiom);
+                    util::Statistics::enable();
+                }
+                if (util::Configuration::instance().trace() != "")
+                {
+                    util::Trace::enable();
                 }
 
-                analysis::Semantics s(*parserResult.program, parserResult.locationToActiveVars, parserResult.problemItems, parserResult.numberOfTraces);
-                auto [semantics, inlinedVarValues] = s.generateSemantics();
-                problemItems.insert(problemItems.end(), semantics.begin(), semantics.end());
+                bool success;
+                {
+                    util::Statistics::ScopedTimer timer("total");
+                    if (util::Configuration::instance().batch())
+                    {
+                        success = generateReasoningTasksForBatch(inputFile, outputDir, util::Configuration::instance().threads());
+                    }
+                    else
+                    {
+                        // check that inputFile ends in ".spec"
+                        std::string extension = ".spec";
+                        assert(inputFile.size() > extension.size());
+                        assert(inputFile.compare(inputFile.size()-extension.size(), extension.size(),extension) == 0);
 
-                auto traceLemmas = analysis::generateTraceLemmas(*parserResult.program, parserResult.locationToActiveVars, parserResult.numberOfTraces, semantics, inlinedVarValues);
-                problemItems.insert(problemItems.end(), traceLemmas.begin(), traceLemmas.end());
-                
+                        success = generateReasoningTasks(inputFile, outputDir, util::Configuration::instance().threads(), std::cout);
+                    }
+                }
 
-                
-                problemItems.insert(problemItems.end(), parserResult.problemItems.begin(), parserResult.problemItems.end());
-                
-                logic::Problem problem(problemItems);
-                
-                // generate reasoning tasks, convert each reasoning task to smtlib, and output it to output-file
-                auto tasks = problem.generateReasoningTasks();
-                for (const auto& task : tasks)
+                if (util::Configuration::instance().stats())
+                {
+                    util::Statistics::outputJSON(std::cout);
+                }
+                if (util::Configuration::instance().trace() != "" && !util::Trace::writeToFile(util::Configuration::instance().trace()))
                 {
-                    std::stringstream preamble;
-                    preamble << util::Output::comment << *parserResult.program << util::Output::nocomment;
-                    task.outputSMTLIBToDir(outputDir, preamble.str());
+                    std::cout << "Error: Unable to write trace file " << util::Configuration::instance().trace() << std::endl;
+                    exit(1);
+                }
+                if (!success)
+                {
+                    exit(1);
                 }
             }
         }
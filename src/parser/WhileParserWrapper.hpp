@@ -1,9 +1,9 @@
 #ifndef __WhileParserWrapper__
 #define __WhileParserWrapper__
 
-#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -38,46 +38,57 @@ namespace parser
         ;
     };
     
+    // the scanner generated by Flex uses global state, so only one input can be parsed at a time
+    std::mutex parserMutex;
+
     /*
-     * main method for parsing input. Internally calls the parser autogenerated by Flex and Bison.
+     * parse the input which has been set as current buffer of the scanner into the given context.
+     * returns nullptr if the input contains an error (which has been reported already).
      */
-    WhileParserResult parse(std::string inputFile)
+    std::unique_ptr<WhileParserResult> parseCurrentBuffer(parser::WhileParsingContext& context)
     {
-        // test readbility, easier than catching exception thrown by parser
-        std::ifstream istr(inputFile);
-        if (!istr)
-        {
-            std::cerr << "Unable to read file " << inputFile << std::endl;
-            exit(1);
-        }
-        
         yy_flex_debug = false;
-        
-        // set parser input to inputFile
-        FILE* f = fopen(inputFile.c_str(), "r");
-        yy_buffer_state*bp = yy_create_buffer(f, YY_BUF_SIZE );
-        yy_create_buffer(f,YY_BUF_SIZE);
-        yy_switch_to_buffer(bp);
-        
-        // generate a context, whose fields are used as in/out-parameters for parsing
-        parser::WhileParsingContext context;
-        context.inputFile = inputFile;
+        resetScanner();
         
         // parse the input-program into context
         parser::WhileParser parser(context);
         parser.set_debug_level(false);
-        parser.parse();
-        fclose(f);
+        try
+        {
+            parser.parse();
+        }
+        catch (const ParseError&)
+        {
+            context.errorFlag = true;
+        }
         
-        // if there was an error during parsing, exit the program.
         if (context.errorFlag)
         {
-            exit(1);
+            return nullptr;
         }
         
         assert(context.program);
         
-        return WhileParserResult(std::move(context.program), std::move(context.locationToActiveVars), std::move(context.problemItems), context.numberOfTraces);
+        return std::unique_ptr<WhileParserResult>(new WhileParserResult(std::move(context.program), std::move(context.locationToActiveVars), std::move(context.problemItems), context.numberOfTraces));
+    }
+
+    /*
+     * parse the given text, and return nullptr if the input contains an error. 'inputName' is used in error messages,
+     * which are reported to 'errors'. Internally calls the parser autogenerated by Flex and Bison. Can be called from several threads.
+     */
+    std::unique_ptr<WhileParserResult> tryParseString(const std::string& input, const std::string& inputName, std::ostream& errors = std::cout)
+    {
+        std::lock_guard<std::mutex> lock(parserMutex);
+        
+        yy_buffer_state* bp = yy_scan_bytes(input.data(), input.size());
+        
+        parser::WhileParsingContext context;
+        context.inputFile = inputName;
+        context.errors = &errors;
+        
+        auto result = parseCurrentBuffer(context);
+        yy_delete_buffer(bp);
+        return result;
     }
 }
 
@@ -84,18 +84,15 @@ namespace parser
         return true;
     }
     
+    bool WhileParsingContext::isProgramVarDeclared(std::string name)
+    {
+        return programVarsDeclarations.count(name) > 0;
+    }
+    
     std::shared_ptr<const program::Variable> WhileParsingContext::getProgramVar(std::string name)
     {
-        if (programVarsDeclarations.count(name) > 0)
-        {
-            return programVarsDeclarations[name];
-        }
-        else
-        {
-            std::cout << "program var " << name << " has not been declared!";
-            assert(false);
-            return nullptr;
-        }
+        assert(isProgramVarDeclared(name));
+        return programVarsDeclarations[name];
     }
     
     std::vector<std::shared_ptr<const program::Variable>> WhileParsingContext::getActiveProgramVars()
@@ -1,6 +1,8 @@
 #ifndef __WhileParsingContext__
 #define __WhileParsingContext__
 
+#include <exception>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -14,6 +16,13 @@
 
 namespace parser
 {
+    // thrown by the parser and the scanner after an error in the input has been reported
+    class ParseError : public std::exception
+    {
+    public:
+        const char* what() const noexcept override { return "error while parsing input"; }
+    };
+
     /*
      * this class is used to communicate with the bison-parser, in particular to
      * get back the parsed program.
@@ -22,10 +31,12 @@ namespace parser
     class WhileParsingContext
     {
     public:
-        WhileParsingContext() : inputFile(""), errorFlag(false), program(nullptr), problemItems(), locationToActiveVars(), numberOfTraces(1), numberOfAxioms(0), numberOfLemmas(0), numberOfConjectures(0), quantifiedVarsDeclarations(), quantifiedVarsStack(), programVarsDeclarations(), programVarsStack() {}
+        WhileParsingContext() : inputFile(""), errors(&std::cout), errorFlag(false), program(nullptr), problemItems(), locationToActiveVars(), numberOfTraces(1), numberOfAxioms(0), numberOfLemmas(0), numberOfConjectures(0), quantifiedVarsDeclarations(), quantifiedVarsStack(), programVarsDeclarations(), programVarsStack() {}
         
         // input
         std::string inputFile;
+        // the stream to which errors in the input are reported
+        std::ostream* errors;
         bool errorFlag;
         
         // output
@@ -55,6 +66,8 @@ namespace parser
         void pushProgramVars();
         void popProgramVars();
         bool addProgramVar(std::shared_ptr<const program::Variable> programVar);
+        bool isProgramVarDeclared(std::string name);
+        // the program variable must have been declared
         std::shared_ptr<const program::Variable> getProgramVar(std::string name);
         std::vector<std::shared_ptr<const program::Variable>> getActiveProgramVars();
         
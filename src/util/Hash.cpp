@@ -0,0 +1,26 @@
+#include "Hash.hpp"
+
+namespace util {
+
+    std::uint64_t contentHash(const std::string& content, std::uint64_t hash)
+    {
+        for (const auto& c : content)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    std::string hashToString(std::uint64_t hash)
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string result(16, '0');
+        for (unsigned i = 16; i-- > 0;)
+        {
+            result[i] = digits[hash & 0xf];
+            hash >>= 4;
+        }
+        return result;
+    }
+}
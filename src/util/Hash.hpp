@@ -0,0 +1,16 @@
+#ifndef __Hash__
+#define __Hash__
+
+#include <cstdint>
+#include <string>
+
+namespace util {
+
+    // 64-bit FNV-1a hash of the given bytes. The hash is stable across platforms and runs, so it can be stored in files.
+    std::uint64_t contentHash(const std::string& content, std::uint64_t hash = 0xcbf29ce484222325ULL);
+
+    // the hash as 16 hexadecimal digits
+    std::string hashToString(std::uint64_t hash);
+}
+
+#endif
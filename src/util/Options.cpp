@@ -1,6 +1,7 @@
 #include "Options.hpp"
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -18,6 +19,18 @@ namespace util {
     }
   }
 
+  bool UnsignedOption::setValue(std::string v) {
+    if (v.empty() || v.find_first_not_of("0123456789") != std::string::npos) {
+      return false;
+    }
+    try {
+      _value = std::stoul(v);
+    } catch (const std::out_of_range&) {
+      return false;
+    }
+    return true;
+  }
+
   bool MultiChoiceOption::setValue(std::string v) {
     for (auto it = _choices.begin(); it != _choices.end(); ++it) {
       if (*it == v) {
@@ -50,10 +63,16 @@ namespace util {
     return b;
   }
 
+  Option* Configuration::getOption(std::string name) {
+    auto it = _allOptions.find(name);
+    return it != _allOptions.end() ? it->second : nullptr;
+  }
+
   void Configuration::registerOption(Option* o) {
     _allOptions.insert(std::pair<std::string, Option*>(o->name(), o));
   }
 
   Configuration Configuration::_instance;
+  thread_local Configuration* Configuration::_current = nullptr;
 
 }
@@ -52,6 +52,21 @@ namespace util {
         std::string _value;
     };
     
+    class UnsignedOption : public Option {
+    public:
+        UnsignedOption(std::string name, unsigned defaultValue) :
+        Option(name),
+        _value(defaultValue)
+        {}
+        
+        bool setValue(std::string v);
+        
+        unsigned getValue() { return _value; }
+        
+    protected:
+        unsigned _value;
+    };
+    
     class MultiChoiceOption : public Option {
     public:
         MultiChoiceOption(std::string name, std::vector<std::string> choices, std::string defaultValue) :
@@ -78,6 +93,22 @@ namespace util {
         _nativeNat("-nat", true),
         _inlineSemantics("-inlineSemantics", true),
         _lemmaPredicates("-lemmaPredicates", true),
+        _shareTerms("-shareTerms", false),
+        _threads("-threads", 1),
+        _incremental("-incremental", false),
+        _sine("-sine", false),
+        _sineDepth("-sineDepth", 0),
+        _outputCache("-outputCache", false),
+        _batch("-batch", false),
+        _server("-server", false),
+        _serverMaxRequestSize("-serverMaxRequestSize", 64),
+        _prover("-prover", ""),
+        _proverTimeout("-proverTimeout", 60),
+        _proverMemoryLimit("-proverMemoryLimit", 0),
+        _proverCache("-proverCache", ""),
+        _stats("-stats", false),
+        _trace("-trace", ""),
+        _sizeReport("-sizeReport", false),
         _allOptions()
         {
             registerOption(&_outputDir);
@@ -85,10 +116,29 @@ namespace util {
             registerOption(&_nativeNat);
             registerOption(&_inlineSemantics);
             registerOption(&_lemmaPredicates);
+            registerOption(&_shareTerms);
+            registerOption(&_threads);
+            registerOption(&_incremental);
+            registerOption(&_sine);
+            registerOption(&_sineDepth);
+            registerOption(&_outputCache);
+            registerOption(&_batch);
+            registerOption(&_server);
+            registerOption(&_serverMaxRequestSize);
+            registerOption(&_prover);
+            registerOption(&_proverTimeout);
+            registerOption(&_proverMemoryLimit);
+            registerOption(&_proverCache);
+            registerOption(&_stats);
+            registerOption(&_trace);
+            registerOption(&_sizeReport);
         }
+        Configuration(const Configuration&) = delete;
+        Configuration& operator=(const Configuration&) = delete;
         
         bool setAllValues(int argc, char *argv[]);
         
+        // returns nullptr if there is no option with the given name
         Option* getOption(std::string name);
         
         std::string outputDir() { return _outputDir.getValue(); }
@@ -96,8 +146,49 @@ namespace util {
         bool nativeNat() { return _nativeNat.getValue(); }
         bool inlineSemantics() { return _inlineSemantics.getValue(); }
         bool lemmaPredicates() { return _lemmaPredicates.getValue(); }
+        bool shareTerms() { return _shareTerms.getValue(); }
+        unsigned threads() { return _threads.getValue(); }
+        bool incremental() { return _incremental.getValue(); }
+        bool sine() { return _sine.getValue(); }
+        // maximal number of rounds of the relevance filter, 0 means unbounded
+        unsigned sineDepth() { return _sineDepth.getValue(); }
+        bool outputCache() { return _outputCache.getValue(); }
+        // process a directory or a list of specs instead of a single spec
+        bool batch() { return _batch.getValue(); }
+        // process specs sent to a socket (or stdin) instead of a single spec
+        bool server() { return _server.getValue(); }
+        // the maximal size of a request in server mode, in megabytes
+        unsigned serverMaxRequestSize() { return _serverMaxRequestSize.getValue(); }
+        // the command line of a prover which is run on the generated tasks, empty if no prover is run
+        std::string prover() { return _prover.getValue(); }
+        // the limits for each run of the prover, in seconds and megabytes, 0 means no limit
+        unsigned proverTimeout() { return _proverTimeout.getValue(); }
+        unsigned proverMemoryLimit() { return _proverMemoryLimit.getValue(); }
+        // the directory in which the results of the prover are cached, empty if no cache is used
+        std::string proverCache() { return _proverCache.getValue(); }
+        // print timers and counters as JSON at the end
+        bool stats() { return _stats.getValue(); }
+        // the file into which a trace of the phases is written in the Chrome trace-event format, empty if no trace is written
+        std::string trace() { return _trace.getValue(); }
+        // write the size of the items of the tasks, attributed to the generators of the items, into size-report.json in the output directory
+        bool sizeReport() { return _sizeReport.getValue(); }
+
+        // the configuration which is current for the current thread, by default the global configuration
+        static Configuration& instance() { return _current != nullptr ? *_current : _instance; }
+
+        // makes the configuration current for the current thread during the lifetime of the scope
+        class Scope
+        {
+        public:
+            Scope(Configuration& configuration) : previous(_current) { _current = &configuration; }
+            ~Scope() { _current = previous; }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
 
-        static Configuration instance() { return _instance; }
+        private:
+            Configuration* previous;
+        };
         
     protected:
         StringOption _outputDir;
@@ -105,12 +196,30 @@ namespace util {
         BooleanOption _nativeNat;
         BooleanOption _inlineSemantics;
         BooleanOption _lemmaPredicates;
+        BooleanOption _shareTerms;
+        UnsignedOption _threads;
+        BooleanOption _incremental;
+        BooleanOption _sine;
+        UnsignedOption _sineDepth;
+        BooleanOption _outputCache;
+        BooleanOption _batch;
+        BooleanOption _server;
+        UnsignedOption _serverMaxRequestSize;
+        StringOption _prover;
+        UnsignedOption _proverTimeout;
+        UnsignedOption _proverMemoryLimit;
+        StringOption _proverCache;
+        BooleanOption _stats;
+        StringOption _trace;
+        BooleanOption _sizeReport;
 
         std::map<std::string, Option*> _allOptions;
         
         void registerOption(Option* o);
         
         static Configuration _instance;
+        // the configuration set by the innermost scope of the current thread, or nullptr if the global configuration is used
+        static thread_local Configuration* _current;
     };
 }
 
@@ -1,5 +1,6 @@
 #include "Output.hpp"
 
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -47,6 +48,30 @@ namespace util {
     return ostr;
   }
 
+  std::string escapeJSON(const std::string& s)
+  {
+    std::string result;
+    for (const auto& c : s)
+    {
+      if (c == '"' || c == '\\')
+      {
+        result += '\\';
+        result += c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+        result += buffer;
+      }
+      else
+      {
+        result += c;
+      }
+    }
+    return result;
+  }
+
     int CommentingStreambuf::overflow(int c)
     {
         if (c == EOF || !_dest) {
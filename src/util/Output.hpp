@@ -2,6 +2,7 @@
 #define __Output__
 
 #include <iostream>
+#include <string>
 
 namespace util {
 
@@ -33,6 +34,9 @@ namespace util {
     static int _commentIndex;
   };
 
+  // escape the characters of 's' which can't occur as they are inside a JSON string
+  std::string escapeJSON(const std::string& s);
+
   class CommentingStreambuf : public std::streambuf
   {
   public:
@@ -0,0 +1,172 @@
+#include "Process.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace util {
+
+    ProcessResult runProcess(const std::vector<std::string>& command, unsigned timeLimit, unsigned memoryLimit)
+    {
+        ProcessResult result;
+        if (command.empty())
+        {
+            return result;
+        }
+
+        // prepare everything before forking, since the child may only use async-signal-safe functions
+        std::vector<char*> argv;
+        for (const auto& argument : command)
+        {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        // the pipe is not inherited by the processes started concurrently by other threads, otherwise the end of the
+        // output would only be detected after all of them have finished
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return result;
+        }
+        if (pid == 0)
+        {
+            // use a new process group, so that the process and its children can be killed together
+            setpgid(0, 0);
+            if (memoryLimit > 0)
+            {
+                rlimit limit;
+                limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(memoryLimit) * 1024 * 1024;
+                setrlimit(RLIMIT_AS, &limit);
+            }
+            int devNull = open("/dev/null", O_RDWR);
+            dup2(devNull, STDIN_FILENO);
+            dup2(fds[1], STDOUT_FILENO);
+            dup2(devNull, STDERR_FILENO);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+        setpgid(pid, pid);
+        close(fds[1]);
+
+        // the remaining time in milliseconds, or -1 if there is no time limit
+        auto remaining = [&]() -> int
+        {
+            if (timeLimit == 0)
+            {
+                return -1;
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            return elapsed >= timeLimit * 1000LL ? 0 : static_cast<int>(timeLimit * 1000LL - elapsed);
+        };
+
+        // read the output until the process closes it or the time is up
+        bool timedOut = false;
+        char buffer[4096];
+        while (true)
+        {
+            auto timeout = remaining();
+            if (timeout == 0)
+            {
+                timedOut = true;
+                break;
+            }
+            pollfd output = {fds[0], POLLIN, 0};
+            auto ready = poll(&output, 1, timeout);
+            if (ready < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ready == 0)
+            {
+                timedOut = true;
+                break;
+            }
+            auto n = ready < 0 ? -1 : read(fds[0], buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            result.output.append(buffer, n);
+        }
+        close(fds[0]);
+
+        // the process may still be running after closing its output
+        // the status is only meaningful if wait4 has reaped the process (it fails e.g. if SIGCHLD is ignored)
+        int status = 0;
+        rusage usage = {};
+        bool reaped = false;
+        while (!timedOut)
+        {
+            auto finished = wait4(pid, &status, WNOHANG, &usage);
+            if (finished == pid)
+            {
+                reaped = true;
+                break;
+            }
+            if (finished < 0 && errno != EINTR)
+            {
+                break;
+            }
+            if (finished == 0)
+            {
+                if (remaining() == 0)
+                {
+                    timedOut = true;
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        if (timedOut)
+        {
+            kill(-pid, SIGKILL);
+            pid_t finished;
+            while ((finished = wait4(pid, &status, 0, &usage)) < 0 && errno == EINTR) {}
+            reaped = finished == pid;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        // on Linux, ru_maxrss is given in kilobytes
+        result.peakMemory = usage.ru_maxrss;
+
+        if (timedOut)
+        {
+            result.status = ProcessResult::Status::Timeout;
+        }
+        else if (!reaped)
+        {
+            // the outcome of the process is unknown, so its output can't be trusted
+            result.status = ProcessResult::Status::NotStarted;
+        }
+        else if (WIFEXITED(status))
+        {
+            result.status = ProcessResult::Status::Exited;
+            result.exitCode = WEXITSTATUS(status);
+        }
+        else
+        {
+            result.status = ProcessResult::Status::Signaled;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef __Process__
+#define __Process__
+
+#include <string>
+#include <vector>
+
+namespace util {
+
+    class ProcessResult
+    {
+    public:
+        // NotStarted is also used if the process couldn't be waited for, so that its exit status is unknown
+        enum class Status { Exited, Signaled, Timeout, NotStarted };
+
+        ProcessResult() : status(Status::NotStarted), exitCode(-1), output(), seconds(0), peakMemory(0) {}
+
+        Status status;
+        // only set if the process has exited
+        int exitCode;
+        // the standard output of the process
+        std::string output;
+        // the wall-clock time used by the process
+        double seconds;
+        // the peak resident set size of the process in kilobytes (not including its child processes)
+        long peakMemory;
+    };
+
+    /*
+     * run the program command[0] (searched in PATH) with the arguments command[1..] and collect its standard output.
+     * the process is killed (together with its child processes) after 'timeLimit' seconds, and its address space is
+     * limited to 'memoryLimit' megabytes. A limit of 0 means no limit. Can be called from several threads.
+     */
+    ProcessResult runProcess(const std::vector<std::string>& command, unsigned timeLimit, unsigned memoryLimit);
+}
+
+#endif
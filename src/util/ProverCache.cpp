@@ -0,0 +1,78 @@
+#include "ProverCache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include <unistd.h>
+
+#include "Hash.hpp"
+
+namespace util {
+
+    namespace {
+        // the offset basis of the second hash of a key, which differs from the one of the hash naming the entry
+        const std::uint64_t checkHashSeed = 0x84222325cbf29ce4ULL;
+    }
+
+    ProverCache::ProverCache(const std::string& directory) : directory(directory)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+    }
+
+    std::string ProverCache::entryFileName(const std::string& key) const
+    {
+        return (std::filesystem::path(directory) / hashToString(contentHash(key))).string();
+    }
+
+    bool ProverCache::lookup(const std::string& key, std::vector<std::string>& answers, double& seconds) const
+    {
+        // an entry consists of the length and a second hash of the key, the time, the number of answers and one answer per line
+        std::ifstream entry(entryFileName(key), std::ios::binary);
+        std::size_t keyLength;
+        std::string checkHash;
+        unsigned numberOfAnswers;
+        if (!entry || !(entry >> keyLength >> checkHash >> seconds >> numberOfAnswers))
+        {
+            return false;
+        }
+        // the entry belongs to a different key with the same hash
+        if (keyLength != key.size() || checkHash != hashToString(contentHash(key, checkHashSeed)))
+        {
+            return false;
+        }
+        answers.clear();
+        std::string answer;
+        for (unsigned i = 0; i < numberOfAnswers && entry >> answer; ++i)
+        {
+            answers.push_back(answer);
+        }
+        return answers.size() == numberOfAnswers;
+    }
+
+    void ProverCache::store(const std::string& key, const std::vector<std::string>& answers, double seconds) const
+    {
+        // write the entry into a temporary file first, so that other processes never read an incomplete entry
+        auto fileName = entryFileName(key);
+        auto temporaryFileName = fileName + ".tmp-" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream entry(temporaryFileName, std::ios::binary);
+            entry << key.size() << " " << hashToString(contentHash(key, checkHashSeed)) << "\n";
+            entry << seconds << "\n" << answers.size() << "\n";
+            for (const auto& answer : answers)
+            {
+                entry << answer << "\n";
+            }
+            if (!entry)
+            {
+                entry.close();
+                std::remove(temporaryFileName.c_str());
+                return;
+            }
+        }
+        std::rename(temporaryFileName.c_str(), fileName.c_str());
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef __ProverCache__
+#define __ProverCache__
+
+#include <string>
+#include <vector>
+
+namespace util {
+
+    /*
+     * a persistent cache of prover results, stored in a directory with one file per entry, so that it survives
+     * between runs and can be shared by several processes.
+     * an entry maps a key (the content of a task file together with the prover command line and its limits) to the
+     * answers of the prover for the checks of the file and the time used by the prover. The entry is stored in a file
+     * named after the hash of the key, and contains the length of the key and a second hash of it with a different seed,
+     * so that a collision of hashes is not mistaken for a hit without storing the key itself.
+     */
+    class ProverCache
+    {
+    public:
+        // the directory is created if it doesn't exist
+        ProverCache(const std::string& directory);
+
+        // returns false if there is no entry for the key
+        bool lookup(const std::string& key, std::vector<std::string>& answers, double& seconds) const;
+        void store(const std::string& key, const std::vector<std::string>& answers, double seconds) const;
+
+    private:
+        const std::string directory;
+
+        std::string entryFileName(const std::string& key) const;
+    };
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include "ProverRunner.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <sstream>
+
+#include "Process.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace util {
+
+    namespace
+    {
+        std::vector<std::string> splitAtSpaces(const std::string& commandLine)
+        {
+            std::vector<std::string> words;
+            std::istringstream istr(commandLine);
+            std::string word;
+            while (istr >> word)
+            {
+                words.push_back(word);
+            }
+            return words;
+        }
+    }
+
+    ProverRunner::ProverRunner(const std::string& command, unsigned timeLimit, unsigned memoryLimit, unsigned numberOfProcesses, const std::string& cacheDirectory) :
+        commandLine(command), command(splitAtSpaces(command)), timeLimit(timeLimit), memoryLimit(memoryLimit), numberOfProcesses(std::max(numberOfProcesses, 1u)),
+        cache(cacheDirectory.empty() ? nullptr : new ProverCache(cacheDirectory)) {}
+
+    std::vector<ProverResult> ProverRunner::run(const std::vector<std::string>& files, const std::vector<std::vector<std::string>>& checks) const
+    {
+        // the results of the prover are the same for files with the same content if the command line and the limits are the same
+        auto cachePrefix = commandLine + "\n" + std::to_string(timeLimit) + "\n" + std::to_string(memoryLimit) + "\n";
+
+        std::vector<std::vector<std::string>> answers(files.size());
+        std::vector<double> seconds(files.size(), 0);
+        std::vector<char> isCached(files.size(), false);
+        {
+            std::vector<std::future<void>> finished;
+            ThreadPool pool(numberOfProcesses);
+            for (unsigned i = 0; i < files.size(); ++i)
+            {
+                finished.push_back(pool.submit([&, i]
+                {
+                    if (cache == nullptr)
+                    {
+                        answers[i] = runProver(files[i], checks[i].size(), seconds[i]);
+                        return;
+                    }
+                    std::ifstream file(files[i], std::ios::binary);
+                    auto key = cachePrefix + std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                    if (cache->lookup(key, answers[i], seconds[i]) && answers[i].size() == checks[i].size())
+                    {
+                        isCached[i] = true;
+                        return;
+                    }
+                    answers[i] = runProver(files[i], checks[i].size(), seconds[i]);
+                    // timeouts and errors (e.g. a missing prover or a crash) are not cached, since they may not occur in the next run
+                    auto isFailure = [](const std::string& answer) { return answer == "timeout" || answer == "error"; };
+                    if (std::none_of(answers[i].begin(), answers[i].end(), isFailure))
+                    {
+                        cache->store(key, answers[i], seconds[i]);
+                    }
+                }));
+            }
+        }
+
+        std::vector<ProverResult> results;
+        for (unsigned i = 0; i < files.size(); ++i)
+        {
+            for (unsigned k = 0; k < checks[i].size(); ++k)
+            {
+                results.emplace_back(checks[i][k], answers[i][k], seconds[i], isCached[i]);
+            }
+        }
+        return results;
+    }
+
+    std::vector<std::string> ProverRunner::runProver(const std::string& file, unsigned numberOfChecks, double& seconds) const
+    {
+        auto fileCommand = command;
+        fileCommand.push_back(file);
+        Trace::Span span("prover", Trace::isEnabled() ? file : "");
+        auto processResult = runProcess(fileCommand, timeLimit, memoryLimit);
+        seconds = processResult.seconds;
+
+        // checks without answer were not reached before the prover stopped
+        auto answers = parseProverAnswers(processResult.output);
+        std::string missingAnswer = "error";
+        if (processResult.status == ProcessResult::Status::Timeout)
+        {
+            missingAnswer = "timeout";
+        }
+        else if (processResult.status == ProcessResult::Status::Exited && processResult.exitCode == 0)
+        {
+            missingAnswer = "unknown";
+        }
+        answers.resize(numberOfChecks, missingAnswer);
+        return answers;
+    }
+
+    void ProverRunner::writeSummary(std::ostream& ostr, const std::vector<ProverResult>& results) const
+    {
+        ostr << "Running all reasoning tasks for " << timeLimit << " seconds\n";
+        ostr << "Prover arguments: " << commandLine << "\n";
+        if (memoryLimit > 0)
+        {
+            ostr << "Memory limit: " << memoryLimit << " MB\n";
+        }
+        ostr << "\n";
+
+        unsigned numberOfProven = 0;
+        for (const auto& result : results)
+        {
+            char seconds[32];
+            std::snprintf(seconds, sizeof(seconds), "%.2f", result.seconds);
+            ostr << "testing task " << result.name << ": " << (result.isProven() ? "SUCCESS" : "DIDN'T WORK") << " (" << result.answer << ", " << seconds << " s" << (result.isCached ? ", cached" : "") << ")\n";
+            numberOfProven += result.isProven() ? 1 : 0;
+        }
+
+        ostr << "\nOverall results:\n";
+        ostr << "#success:" << numberOfProven << "\n";
+        ostr << "#fail:" << results.size() - numberOfProven << "\n";
+    }
+
+    std::vector<std::string> parseProverAnswers(const std::string& output)
+    {
+        // provers running in TPTP-mode (e.g. Vampire in CASC-mode) report the status using the SZS ontology, often in
+        // addition to the plain answer. So the SZS lines are only used if the output contains no plain answer.
+        std::vector<std::string> answers;
+        std::vector<std::string> szsAnswers;
+        std::istringstream istr(output);
+        std::string line;
+        while (std::getline(istr, line))
+        {
+            auto begin = line.find_first_not_of(" \t\r");
+            auto end = line.find_last_not_of(" \t\r");
+            if (begin == std::string::npos)
+            {
+                continue;
+            }
+            line = line.substr(begin, end - begin + 1);
+            if (line == "sat" || line == "unsat" || line == "unknown")
+            {
+                answers.push_back(line);
+            }
+            else if (line.find("SZS status Unsatisfiable") != std::string::npos || line.find("SZS status Theorem") != std::string::npos)
+            {
+                szsAnswers.push_back("unsat");
+            }
+            else if (line.find("SZS status Satisfiable") != std::string::npos || line.find("SZS status CounterSatisfiable") != std::string::npos)
+            {
+                szsAnswers.push_back("sat");
+            }
+        }
+        return answers.empty() ? szsAnswers : answers;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __ProverRunner__
+#define __ProverRunner__
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProverCache.hpp"
+
+namespace util {
+
+    // the result of a prover for a single reasoning task
+    class ProverResult
+    {
+    public:
+        ProverResult(std::string name, std::string answer, double seconds, bool isCached) : name(std::move(name)), answer(std::move(answer)), seconds(seconds), isCached(isCached) {}
+
+        std::string name;
+        // sat, unsat or unknown, or the reason why the prover didn't answer (timeout or error)
+        std::string answer;
+        // the time used by the prover for the file containing the task
+        double seconds;
+        // true if the result was taken from the cache instead of running the prover
+        bool isCached;
+
+        // the conjecture of a task is negated, so it is proven if the prover shows unsatisfiability
+        bool isProven() const { return answer == "unsat"; }
+    };
+
+    /*
+     * runs a local prover (any executable which reads an SMTLIB-file and prints sat, unsat or unknown for each check)
+     * on the files of generated reasoning tasks, using a bounded number of prover processes at the same time.
+     */
+    class ProverRunner
+    {
+    public:
+        // 'command' is the prover followed by its arguments, separated by spaces. The file is passed as last argument.
+        // the limits are given in seconds and megabytes, and 0 means no limit.
+        // if 'cacheDirectory' is not empty, the results are cached in it, and the prover is only run on files whose
+        // content has not been checked before with the same command line and limits.
+        ProverRunner(const std::string& command, unsigned timeLimit, unsigned memoryLimit, unsigned numberOfProcesses, const std::string& cacheDirectory = "");
+
+        /*
+         * run the prover on each of the files. 'checks[i]' are the names of the tasks checked by 'files[i]' (one task
+         * for the file of a task, all tasks for an incremental script): the k-th answer of the prover is the result of
+         * the k-th check. Returns the results of all checks, in order.
+         */
+        std::vector<ProverResult> run(const std::vector<std::string>& files, const std::vector<std::vector<std::string>>& checks) const;
+
+        // write an overview of the results and the number of proven and failed tasks
+        void writeSummary(std::ostream& ostr, const std::vector<ProverResult>& results) const;
+
+    private:
+        const std::string commandLine;
+        const std::vector<std::string> command;
+        const unsigned timeLimit;
+        const unsigned memoryLimit;
+        const unsigned numberOfProcesses;
+        const std::unique_ptr<const ProverCache> cache;
+
+        // the answers for the 'numberOfChecks' checks of the file, and the time used by the prover
+        std::vector<std::string> runProver(const std::string& file, unsigned numberOfChecks, double& seconds) const;
+    };
+
+    // the answers (sat, unsat or unknown) in the output of a prover, in order. SZS status lines are only used if there is no plain answer
+    std::vector<std::string> parseProverAnswers(const std::string& output);
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "Output.hpp"
+
+namespace util {
+
+    bool Statistics::_enabled = false;
+
+    namespace
+    {
+        class Timer
+        {
+        public:
+            Timer() : seconds(0), calls(0) {}
+
+            double seconds;
+            std::uint64_t calls;
+        };
+
+        // the recorded values. The state is created on first use, since counters register themselves during static initialization.
+        class State
+        {
+        public:
+            std::mutex mutex;
+            std::vector<const Statistics::Counter*> staticCounters;
+            std::map<std::string, std::uint64_t> counters;
+            std::map<std::string, Timer> timers;
+            std::vector<std::pair<std::string, std::uint64_t>> tasks;
+        };
+
+        State& state()
+        {
+            static State* state = new State();
+            return *state;
+        }
+    }
+
+    Statistics::Counter::Counter(std::string name) : name(std::move(name)), value(0)
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().staticCounters.push_back(this);
+    }
+
+    void Statistics::ScopedTimer::stop()
+    {
+        if (name.empty())
+        {
+            return;
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (_enabled)
+        {
+            auto seconds = std::chrono::duration<double>(end - start).count();
+            std::lock_guard<std::mutex> lock(state().mutex);
+            auto& timer = state().timers[name];
+            timer.seconds += seconds;
+            timer.calls++;
+        }
+        Trace::addSpan("phase", name, start, end);
+        name.clear();
+    }
+
+    void Statistics::add(const std::string& name, std::uint64_t value)
+    {
+        if (!_enabled)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().counters[name] += value;
+    }
+
+    void Statistics::addTask(const std::string& name, std::uint64_t bytes)
+    {
+        if (!_enabled)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().tasks.emplace_back(name, bytes);
+    }
+
+    void Statistics::outputJSON(std::ostream& ostr)
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+
+        ostr << "{\n  \"timers\": {";
+        bool first = true;
+        for (const auto& [name, timer] : state().timers)
+        {
+            char seconds[32];
+            std::snprintf(seconds, sizeof(seconds), "%.6f", timer.seconds);
+            ostr << (first ? "\n" : ",\n") << "    \"" << escapeJSON(name) << "\": {\"seconds\": " << seconds << ", \"calls\": " << timer.calls << "}";
+            first = false;
+        }
+
+        // the counters are reported in alphabetical order
+        auto counters = state().counters;
+        for (const auto& counter : state().staticCounters)
+        {
+            counters[counter->name] += counter->value.load();
+        }
+        ostr << "\n  },\n  \"counters\": {";
+        first = true;
+        for (const auto& [name, value] : counters)
+        {
+            ostr << (first ? "\n" : ",\n") << "    \"" << escapeJSON(name) << "\": " << value;
+            first = false;
+        }
+
+        // tasks output in parallel are recorded in any order
+        auto tasks = state().tasks;
+        std::sort(tasks.begin(), tasks.end());
+        std::uint64_t totalBytes = 0;
+        ostr << "\n  },\n  \"tasks\": [";
+        first = true;
+        for (const auto& [name, bytes] : tasks)
+        {
+            ostr << (first ? "\n" : ",\n") << "    {\"name\": \"" << escapeJSON(name) << "\", \"bytes\": " << bytes << "}";
+            totalBytes += bytes;
+            first = false;
+        }
+        ostr << "\n  ],\n  \"totalTaskBytes\": " << totalBytes << ",\n";
+
+        // on Linux, ru_maxrss is given in kilobytes
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        ostr << "  \"peakRSSKiB\": " << usage.ru_maxrss << "\n}\n";
+    }
+}
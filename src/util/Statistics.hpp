@@ -0,0 +1,77 @@
+#ifndef __Statistics__
+#define __Statistics__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace util {
+
+    /*
+     * timers and counters for the phases of rapid, which are reported as JSON if the option -stats is on.
+     * nothing is recorded unless the statistics are enabled. All methods can be called from several threads;
+     * the times of phases which run in parallel (e.g. in batch mode) are added up.
+     */
+    class Statistics
+    {
+    public:
+        static bool isEnabled() { return _enabled; }
+        static void enable() { _enabled = true; }
+
+        // a counter which is cheap to increment, for events which happen often (e.g. the creation of a term).
+        // counters must have static storage duration.
+        class Counter
+        {
+        public:
+            Counter(std::string name);
+
+            Counter(const Counter&) = delete;
+            Counter& operator=(const Counter&) = delete;
+
+            void increment() { if (_enabled) value.fetch_add(1, std::memory_order_relaxed); }
+
+        private:
+            const std::string name;
+            std::atomic<std::uint64_t> value;
+
+            friend class Statistics;
+        };
+
+        // measures the time from its construction to its destruction (or to the call of stop) and adds it to the timer with the given name.
+        // if tracing is enabled, the time is also recorded as span of the category "phase".
+        class ScopedTimer
+        {
+        public:
+            ScopedTimer(std::string name) : name(_enabled || Trace::isEnabled() ? std::move(name) : std::string()), start(std::chrono::steady_clock::now()) {}
+            ~ScopedTimer() { stop(); }
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+            void stop();
+
+        private:
+            // empty if the time is not recorded (anymore)
+            std::string name;
+            const std::chrono::steady_clock::time_point start;
+        };
+
+        // add 'value' to the counter with the given name
+        static void add(const std::string& name, std::uint64_t value);
+        // record the number of bytes output for a reasoning task (or an incremental script)
+        static void addTask(const std::string& name, std::uint64_t bytes);
+
+        // output the timers, the counters, the size of each task and the peak resident set size as JSON object
+        static void outputJSON(std::ostream& ostr);
+
+    private:
+        static bool _enabled;
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+#include "ThreadPool.hpp"
+
+#include <cassert>
+
+namespace util {
+
+    ThreadPool::ThreadPool(unsigned numberOfThreads) : workers(), jobs(), mutex(), jobAvailable(), stopping(false)
+    {
+        assert(numberOfThreads > 0);
+        for (unsigned i = 0; i < numberOfThreads; ++i)
+        {
+            workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::future<void> ThreadPool::submit(std::function<void()> job)
+    {
+        std::packaged_task<void()> task(std::move(job));
+        auto result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            assert(!stopping);
+            jobs.push(std::move(task));
+        }
+        jobAvailable.notify_one();
+        return result;
+    }
+
+    void ThreadPool::work()
+    {
+        while (true)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this]{ return stopping || !jobs.empty(); });
+                // finish the remaining jobs before stopping
+                if (jobs.empty())
+                {
+                    return;
+                }
+                task = std::move(jobs.front());
+                jobs.pop();
+            }
+            task();
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef __ThreadPool__
+#define __ThreadPool__
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+    /*
+     * a fixed number of worker threads which process submitted jobs in the order of submission.
+     * the destructor waits until all submitted jobs are finished.
+     */
+    class ThreadPool
+    {
+    public:
+        ThreadPool(unsigned numberOfThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // the returned future becomes ready when the job is finished (and rethrows exceptions thrown by the job)
+        std::future<void> submit(std::function<void()> job);
+
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::packaged_task<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        bool stopping;
+
+        void work();
+    };
+}
+
+#endif
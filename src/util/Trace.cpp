@@ -0,0 +1,113 @@
+#include "Trace.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cxxabi.h>
+
+#include "Output.hpp"
+
+namespace util {
+
+    bool Trace::_enabled = false;
+
+    namespace
+    {
+        class Event
+        {
+        public:
+            Event(const char* category, std::string name, unsigned thread, double start, double duration) :
+                category(category), name(std::move(name)), thread(thread), start(start), duration(duration) {}
+
+            const char* category;
+            std::string name;
+            unsigned thread;
+            // in microseconds
+            double start;
+            double duration;
+        };
+
+        class State
+        {
+        public:
+            std::mutex mutex;
+            Trace::Clock::time_point origin;
+            std::vector<Event> events;
+        };
+
+        State& state()
+        {
+            static State* state = new State();
+            return *state;
+        }
+
+        // each thread gets a small number, in the order in which the threads record their first span.
+        // the thread which enables tracing (i.e. the main thread) gets number 1.
+        unsigned threadNumber()
+        {
+            static std::atomic<unsigned> numberOfThreads(0);
+            thread_local unsigned number = ++numberOfThreads;
+            return number;
+        }
+    }
+
+    void Trace::enable()
+    {
+        threadNumber();
+        state().origin = Clock::now();
+        _enabled = true;
+    }
+
+    void Trace::addSpan(const char* category, const std::string& name, Clock::time_point start, Clock::time_point end)
+    {
+        if (!_enabled)
+        {
+            return;
+        }
+        auto thread = threadNumber();
+        std::lock_guard<std::mutex> lock(state().mutex);
+        auto startMicroseconds = std::chrono::duration<double, std::micro>(start - state().origin).count();
+        auto durationMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
+        state().events.emplace_back(category, name, thread, startMicroseconds, durationMicroseconds);
+    }
+
+    bool Trace::writeToFile(const std::string& fileName)
+    {
+        std::ofstream ostr(fileName);
+        if (!ostr)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(state().mutex);
+        unsigned numberOfThreads = 0;
+        ostr << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        for (const auto& event : state().events)
+        {
+            char times[64];
+            std::snprintf(times, sizeof(times), "\"ts\": %.3f, \"dur\": %.3f", event.start, event.duration);
+            ostr << "{\"name\": \"" << escapeJSON(event.name) << "\", \"cat\": \"" << event.category << "\", \"ph\": \"X\", " << times << ", \"pid\": 1, \"tid\": " << event.thread << "},\n";
+            numberOfThreads = std::max(numberOfThreads, event.thread);
+        }
+        // name the tracks of the threads
+        ostr << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"rapid\"}}";
+        for (unsigned thread = 1; thread <= numberOfThreads; ++thread)
+        {
+            ostr << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread << ", \"args\": {\"name\": \"" << (thread == 1 ? std::string("main") : "worker " + std::to_string(thread - 1)) << "\"}}";
+        }
+        ostr << "\n]}\n";
+        return static_cast<bool>(ostr);
+    }
+
+    std::string Trace::typeName(const std::type_info& type)
+    {
+        int status = 0;
+        std::unique_ptr<char, void(*)(void*)> demangled(abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), std::free);
+        return status == 0 ? std::string(demangled.get()) : std::string(type.name());
+    }
+}
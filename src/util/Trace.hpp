@@ -0,0 +1,56 @@
+#ifndef __Trace__
+#define __Trace__
+
+#include <chrono>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+namespace util {
+
+    /*
+     * records spans (named intervals of time) and writes them as a file in the Chrome trace-event format, which can be
+     * viewed in chrome://tracing or Perfetto. The spans of a thread nest, and each thread is shown as its own track.
+     * nothing is recorded unless tracing is enabled (option -trace). All methods can be called from several threads.
+     */
+    class Trace
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        static bool isEnabled() { return _enabled; }
+        // start recording. The times of the spans are given relative to the call of enable.
+        static void enable();
+
+        // write all recorded spans into the file, returns false if the file can't be written
+        static bool writeToFile(const std::string& fileName);
+
+        // records a span of the current thread from its construction to its destruction
+        class Span
+        {
+        public:
+            // note: pass an empty name if tracing is disabled, to avoid building the name
+            Span(const char* category, std::string name) : category(category), name(_enabled ? std::move(name) : std::string()), start(_enabled ? Clock::now() : Clock::time_point()) {}
+            ~Span() { if (_enabled) addSpan(category, name, start, Clock::now()); }
+
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+        private:
+            const char* const category;
+            const std::string name;
+            const Clock::time_point start;
+        };
+
+        // record a span of the current thread which has been measured by the caller
+        static void addSpan(const char* category, const std::string& name, Clock::time_point start, Clock::time_point end);
+
+        // the readable name of a type, e.g. "analysis::ValueEvolutionLemmas"
+        static std::string typeName(const std::type_info& type);
+
+    private:
+        static bool _enabled;
+    };
+}
+
+#endif
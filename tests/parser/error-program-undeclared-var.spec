@@ -0,0 +1,9 @@
+func main()
+{
+	Int i;
+	i = j;
+}
+
+(assert-not
+	True
+)
\ No newline at end of file
@@ -0,0 +1,102 @@
+#!/bin/sh
+# checks running a prover on the generated tasks (option -prover), using mock-prover.sh instead of a real prover.
+# usage: check.sh <rapid executable>
+# prints each failed check and returns 1 if any check failed.
+
+if [ $# -ne 1 ]; then
+    echo "Usage: check.sh <rapid executable>"
+    exit 2
+fi
+rapid="$1"
+testDir=$(cd "$(dirname "$0")" && pwd)
+mock="$testDir/mock-prover.sh"
+spec="$testDir/../../examples/arrays/copy.spec"
+outputDir=$(mktemp -d)
+trap 'rm -rf "$outputDir"' EXIT
+failures=0
+
+fail()
+{
+    echo "FAILED: $1"
+    failures=$((failures + 1))
+}
+
+# run rapid on the spec with the mock prover behaving as given by $1, and the remaining arguments as options
+run()
+{
+    behavior="$1"
+    shift
+    rm -rf "$outputDir"/*
+    "$rapid" -dir "$outputDir/" -prover "$mock $behavior" "$@" "$spec" > "$outputDir/log.txt" 2>&1 || fail "$behavior: rapid failed"
+    results="$outputDir/results.txt"
+    tasks=$(grep -c "^testing task " "$results")
+}
+
+# check that each of the tasks has the answer $2, and that $3 tasks are proven
+expectAll()
+{
+    answers=$(grep -c "^testing task .*: .* ($2, [0-9.]* s)$" "$results")
+    [ "$tasks" -gt 0 ] && [ "$answers" -eq "$tasks" ] || fail "$1: expected answer $2 for all $tasks tasks, got $answers"
+    grep -q "^#success:$3$" "$results" || fail "$1: expected #success:$3"
+    grep -q "^#fail:$((tasks - $3))$" "$results" || fail "$1: expected #fail:$((tasks - $3))"
+}
+
+# plain answers, and the format of the summary
+run unsat -proverTimeout 30
+head -n 1 "$results" | grep -q "^Running all reasoning tasks for 30 seconds$" || fail "summary: header"
+grep -q "^Prover arguments: $mock unsat$" "$results" || fail "summary: prover arguments"
+grep -q "^testing task user-conjecture-0: SUCCESS (unsat, [0-9]*\.[0-9][0-9] s)$" "$results" || fail "summary: line of a proven task"
+grep -q "^Overall results:$" "$results" || fail "summary: overall results"
+grep -q "Proved $tasks of $tasks reasoning tasks" "$outputDir/log.txt" || fail "summary: log message"
+expectAll unsat unsat "$tasks"
+
+run sat
+grep -q "^testing task user-conjecture-0: DIDN'T WORK (sat, " "$results" || fail "summary: line of a failed task"
+expectAll sat sat 0
+
+run unknown
+expectAll unknown unknown 0
+
+# status lines of provers in TPTP-mode
+run szs
+expectAll szs unsat "$tasks"
+
+# plain answers followed by SZS status lines are counted once
+run alternating -incremental on
+first=$(grep -m 1 "^testing task " "$results")
+second=$(grep -m 2 "^testing task " "$results" | tail -n 1)
+echo "$first" | grep -q "(sat, " || fail "alternating: expected sat for the first check, got $first"
+echo "$second" | grep -q "(unsat, " || fail "alternating: expected unsat for the second check, got $second"
+grep -q "^#success:$((tasks / 2))$" "$results" || fail "alternating: expected #success:$((tasks / 2))"
+
+# limits and failures
+run timeout -incremental on -proverTimeout 1
+expectAll timeout timeout 0
+
+run memory -incremental on -proverMemoryLimit 64
+grep -q "^Memory limit: 64 MB$" "$results" || fail "summary: memory limit"
+expectAll memory error 0
+
+run exit -incremental on
+expectAll exit error 0
+
+# the cache: answers are cached, timeouts are not, and an entry whose stored key length differs (as for a collision of hashes) is not used
+cacheDir=$(mktemp -d)
+trap 'rm -rf "$outputDir" "$cacheDir"' EXIT
+run unsat -proverCache "$cacheDir"
+run unsat -proverCache "$cacheDir"
+[ "$(grep -c ", cached)$" "$results")" -eq "$tasks" ] || fail "cache: expected all results from the cache"
+for entry in "$cacheDir"/*; do
+    { printf 1; cat "$entry"; } > "$entry.changed" && mv "$entry.changed" "$entry"
+done
+run unsat -proverCache "$cacheDir"
+[ "$(grep -c ", cached)$" "$results")" -eq 0 ] || fail "cache: expected no results from entries with a different key"
+run timeout -incremental on -proverTimeout 1 -proverCache "$cacheDir"
+run timeout -incremental on -proverTimeout 1 -proverCache "$cacheDir"
+[ "$(grep -c ", cached)$" "$results")" -eq 0 ] || fail "cache: expected timeouts not to be cached"
+
+if [ $failures -gt 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+echo "All checks passed"
@@ -0,0 +1,33 @@
+#!/bin/sh
+# mock prover for the checks in check.sh, called as: mock-prover.sh <behavior> <file>
+# for each (check-sat) in the file, the behavior
+#   sat, unsat, unknown  prints the answer
+#   szs                  prints the answer unsat as SZS status line only
+#   alternating          prints sat and unsat alternately, each followed by the same answer as SZS status line
+#   timeout              sleeps forever
+#   memory               allocates memory until it fails
+#   exit                 prints nothing and exits with code 3
+
+behavior="$1"
+file="$2"
+checks=$(grep -c "check-sat" "$file")
+
+i=0
+while [ $i -lt $checks ]; do
+    case "$behavior" in
+        sat|unsat|unknown) echo "$behavior" ;;
+        szs) echo "% SZS status Unsatisfiable for $file" ;;
+        alternating)
+            if [ $((i % 2)) -eq 0 ]; then
+                echo "sat"
+                echo "% SZS status Satisfiable for $file"
+            else
+                echo "unsat"
+                echo "% SZS status Unsatisfiable for $file"
+            fi ;;
+        timeout) sleep 1000 ;;
+        memory) awk 'BEGIN { s = "x"; while (1) s = s s }' ; exit 1 ;;
+        exit) exit 3 ;;
+    esac
+    i=$((i + 1))
+done